@@ -0,0 +1,145 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include "BigNum.hpp"
+#include "BasicMathFuncs.hpp"
+
+namespace cg {
+
+/**Reduce numbers modulo a fixed modulus (Barrett reduction).  The
+reciprocal of the modulus is found once, then each reduction is two
+multiplications and at most a couple of subtractions.  Use with
+BigNum::operator%=.
+\tparam DataType The type of the digits.
+\tparam Units The amount of digits of the modulus type.*/
+template<typename DataType, std::size_t Units>
+class BarrettReducer
+{
+public:
+	/**A self reference type.*/
+	using Self = BarrettReducer<DataType, Units>;
+	/**Create a reducer.
+	\param m The modulus.  Must not be zero.*/
+	BarrettReducer(const BigNum<DataType, Units>& m)
+		:m_size(m.RealSize())
+	{
+		if (m_size == 0)
+			throw std::invalid_argument("Modulus is zero.");
+		const std::size_t n = m_size;
+		m_data = new DataType[n + (n + 2) + (5 * n + 6)];
+		m_mu = m_data + n;
+		m_work = m_mu + n + 2;
+		std::memcpy(m_data, m.Begin(), n * sizeof(DataType));
+		/*mu = B^(2n) / m*/
+		ZeroOut(m_work, n + n + 1);
+		m_work[n + n] = 1;
+		DivArray_Split(m_work, n + n + 1, m_data, n, (DataType*)nullptr);
+		std::memcpy(m_mu, m_work, (n + 2) * sizeof(DataType));
+	}
+	/**Reducers own their buffers and are not copied.*/
+	BarrettReducer(const Self&) = delete;
+	/**Reducers own their buffers and are not copied.*/
+	void operator=(const Self&) = delete;
+	/**Free the buffers.*/
+	~BarrettReducer()
+	{
+		delete[] m_data;
+	}
+	/**Reduce a number.  Numbers less than the modulus squared take one step,
+	larger ones take a step for each amount of digits in the modulus they
+	have past that.  Works in the reducer's own space, so each thread needs
+	its own reducer.
+	\param x The number.  Will be x mod the modulus.*/
+	template<std::size_t S>
+	void Reduce(BigNum<DataType, S>& x)
+	{
+		Reduce(x.Begin(), x.RealSize());
+	}
+	/**Reduce an array.
+	\param arr The array.  Will be arr mod the modulus, with zeros above.
+	\param s The size of arr.*/
+	void Reduce(DataType* arr, std::size_t s)
+	{
+		const std::size_t n = m_size;
+		s = RealSize(arr, s);
+		/*Reduce the top 2n digits until only 2n are left.*/
+		while (s > n + n)
+		{
+			const std::size_t k = s - n - n;
+			ReduceWindow(arr + k, n + n);
+			s = RealSize(arr, k + n);
+		}
+		if (s >= n)
+			ReduceWindow(arr, s);
+	}
+	/**Get the size of the modulus.
+	\return The amount of digits in the modulus.*/
+	std::size_t Size() const
+	{
+		return m_size;
+	}
+	/**Direct access to the modulus.
+	\return A pointer to the Size() digits of the modulus.*/
+	const DataType* Modulus() const
+	{
+		return m_data;
+	}
+private:
+	/**Reduce one part of a number.
+	\param x The part.  Will be reduced, with zeros above the result.
+	\param s The size of x.  Must be at least Size() and at most twice that.*/
+	void ReduceWindow(DataType* x, const std::size_t s)
+	{
+		const std::size_t n = m_size;
+		DataType* t = m_work;
+		DataType* u = t + n + n + 3;
+		DataType* r = u + n + n + 2;
+		/*q = ((x / B^(n-1)) * mu) / B^(n+1), at most 2 less than x / m.*/
+		const std::size_t sq = s - (n - 1);
+		MulArray(t, m_mu, n + 2, x + n - 1, sq);
+		const DataType* q = t + n + 1;
+		/*r = (x - q * m) mod B^(n+1)*/
+		MulArray(u, m_data, n, q, sq + 1);
+		ZeroOut(r, n + 1);
+		std::memcpy(r, x, (s < n + 1 ? s : n + 1) * sizeof(DataType));
+		SubArray(r, n + 1, u, n + 1);
+		while (CompareArray(r, RealSize(r, n + 1), m_data, n) != -1)
+			SubArray(r, n + 1, m_data, n);
+		std::memcpy(x, r, n * sizeof(DataType));
+		ZeroOut(x + n, s - n);
+	}
+	/**The amount of digits in the modulus.*/
+	std::size_t m_size;
+	/**The modulus, followed by mu and the work space.*/
+	DataType* m_data;
+	/**floor(B^(2n) / m), n + 2 digits since it is B^(n+1) when m is
+	B^(n-1).*/
+	DataType* m_mu;
+	/**Space for the products of a reduction.*/
+	DataType* m_work;
+};
+
+}
@@ -127,6 +127,8 @@ void ShiftSigB(T* arr1, std::size_t s1, std::size_t amt)
 	std::size_t leftOver = amt % 8;
 	if (bytes > 0)
 		ShiftSig<uint8_t>((uint8_t*)arr1, s1 * sizeof(T), bytes);
+	if (leftOver == 0)
+		return;
 	T carry = 0;
 	auto beg = arr1;
 	auto end = arr1 + s1;
@@ -189,6 +191,8 @@ void ShiftInsigB(T* arr1, std::size_t s1, std::size_t amt)
 	std::size_t leftOver = amt % 8;
 	if (bytes > 0)
 		ShiftInsig<uint8_t>((uint8_t*)arr1, s1 * sizeof(T), bytes);
+	if (leftOver == 0)
+		return;
 	T carry = 0;
 	auto beg = arr1 + s1 - 1;
 	auto end = arr1 - 1;
@@ -209,6 +213,63 @@ void ShiftInsigB(cg::ArrayView<T>& arr1, std::size_t amt)
 {
 	ShiftInsigB(arr1.Begin(), arr1.Size(), amt);
 }
+/**Read a run of bits out of an array.
+\param arr The array.
+\param s The size of the array.
+\param pos The bit number of the first bit to read.  Bit numbers start at 0.
+\param amt The amount of bits to read.  Must be 64 or less.
+\return The bits, with bit `pos` of the array as bit 0.  Bits past the end
+of the array read as zero.*/
+template<typename T>
+uint64_t ReadBits(const T* arr, std::size_t s, std::size_t pos,
+	std::size_t amt)
+{
+	const static std::size_t TBits = (sizeof(T) * 8);
+	uint64_t ret = 0;
+	std::size_t done = 0;
+	while (done < amt)
+	{
+		const std::size_t unit = (pos + done) / TBits;
+		if (unit >= s)
+			break;
+		const std::size_t off = (pos + done) % TBits;
+		std::size_t take = TBits - off;
+		take = take < amt - done ? take : amt - done;
+		uint64_t bits = uint64_t(arr[unit] >> off);
+		if (take < 64)
+			bits &= (uint64_t(1) << take) - 1;
+		ret |= bits << done;
+		done += take;
+	}
+	return ret;
+}
+/**Write a run of bits in to an array.
+\param arr The array.
+\param s The size of the array.
+\param pos The bit number of the first bit to write.  Bit numbers start at 0.
+\param amt The amount of bits to write.  Must be 64 or less.
+\param bits The bits to write, with bit 0 going to bit `pos` of the array.
+Bits past the end of the array are dropped.*/
+template<typename T>
+void WriteBits(T* arr, std::size_t s, std::size_t pos, std::size_t amt,
+	uint64_t bits)
+{
+	const static std::size_t TBits = (sizeof(T) * 8);
+	std::size_t done = 0;
+	while (done < amt)
+	{
+		const std::size_t unit = (pos + done) / TBits;
+		if (unit >= s)
+			break;
+		const std::size_t off = (pos + done) % TBits;
+		std::size_t take = TBits - off;
+		take = take < amt - done ? take : amt - done;
+		const T mask = take < TBits ? T((T(1) << take) - 1) : T(~T(0));
+		const T val = T(bits >> done) & mask;
+		arr[unit] = T((arr[unit] & ~T(mask << off)) | T(val << off));
+		done += take;
+	}
+}
 /**Determine the bit number of the most significant bit. Bit numbers start at 0
 \param arr The array.
 \param s The size of the array.
@@ -28,9 +28,273 @@ along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
 #include "Type.hpp"
 #include "BasicBits.hpp"
 #include "ArrayView.hpp"
+#include "Thresholds.hpp"
+#include "Kernels.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 namespace cg
 {
+/**Add two units and an incoming carry.
+\param c The incoming carry. Must be 0 or 1.
+\param a The first unit.
+\param b The second unit.
+\param out [out] The sum of a, b and c.
+\return The outgoing carry (0 or 1).*/
+template<typename T>
+inline unsigned char AddCarry(unsigned char c, const T a, const T b, T& out)
+{
+	T s = T(a + b);
+	unsigned char c1 = s < a;
+	out = T(s + c);
+	return c1 | (out < s);
+}
+/**Sub two units and an incoming borrow.
+\param c The incoming borrow. Must be 0 or 1.
+\param a The unit to sub from.
+\param b The unit to sub.
+\param out [out] The result of a - b - c.
+\return The outgoing borrow (0 or 1).*/
+template<typename T>
+inline unsigned char SubBorrow(unsigned char c, const T a, const T b, T& out)
+{
+	T d = T(a - b);
+	unsigned char c1 = b > a;
+	out = T(d - c);
+	return c1 | (c > d);
+}
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) \
+	|| defined(__i386__)
+/**\sa AddCarry*/
+template<>
+inline unsigned char AddCarry<uint32_t>(unsigned char c, const uint32_t a,
+	const uint32_t b, uint32_t& out)
+{
+	unsigned int o;
+	c = _addcarry_u32(c, a, b, &o);
+	out = o;
+	return c;
+}
+/**\sa SubBorrow*/
+template<>
+inline unsigned char SubBorrow<uint32_t>(unsigned char c, const uint32_t a,
+	const uint32_t b, uint32_t& out)
+{
+	unsigned int o;
+	c = _subborrow_u32(c, a, b, &o);
+	out = o;
+	return c;
+}
+#endif
+#if defined(_M_X64) || defined(__x86_64__)
+/**\sa AddCarry*/
+template<>
+inline unsigned char AddCarry<uint64_t>(unsigned char c, const uint64_t a,
+	const uint64_t b, uint64_t& out)
+{
+	unsigned long long o;
+	c = _addcarry_u64(c, a, b, &o);
+	out = o;
+	return c;
+}
+/**\sa SubBorrow*/
+template<>
+inline unsigned char SubBorrow<uint64_t>(unsigned char c, const uint64_t a,
+	const uint64_t b, uint64_t& out)
+{
+	unsigned long long o;
+	c = _subborrow_u64(c, a, b, &o);
+	out = o;
+	return c;
+}
+#endif
+/**Multiply two units by splitting them into half units.  Used when there is
+no promoted type to hold the whole product.
+\param a The first unit.
+\param b The second unit.
+\param hi [out] The hi unit of the product.
+\return The lo unit of the product.*/
+template<typename T>
+inline T MulUnit(const T a, const T b, T& hi, std::false_type)
+{
+	const std::size_t H = sizeof(T) * 4;
+	const T M = T((T(1) << H) - 1);
+	const T a0 = T(a & M), a1 = T(a >> H);
+	const T b0 = T(b & M), b1 = T(b >> H);
+	const T p00 = T(a0 * b0), p01 = T(a0 * b1);
+	const T p10 = T(a1 * b0), p11 = T(a1 * b1);
+	const T mid = T((p00 >> H) + (p01 & M) + (p10 & M));
+	hi = T(p11 + (p01 >> H) + (p10 >> H) + (mid >> H));
+	return T((mid << H) | (p00 & M));
+}
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+/**\sa MulUnit
+MSVC has no 128 bit type, but has the full 64 bit product as an intrinsic.*/
+template<>
+inline uint64_t MulUnit<uint64_t>(const uint64_t a, const uint64_t b,
+	uint64_t& hi, std::false_type)
+{
+	unsigned __int64 h;
+	const uint64_t lo = _umul128(a, b, &h);
+	hi = h;
+	return lo;
+}
+#endif
+/**Multiply two units using the promoted type to hold the product.
+\param a The first unit.
+\param b The second unit.
+\param hi [out] The hi unit of the product.
+\return The lo unit of the product.*/
+template<typename T>
+inline T MulUnit(const T a, const T b, T& hi, std::true_type)
+{
+	using PT = typename cg::PromoteType<T>::Type;
+	const PT p = PT(a) * PT(b);
+	hi = T(p >> (sizeof(T) * 8));
+	return T(p);
+}
+/**Multiply two units into a double unit product.
+\param a The first unit.
+\param b The second unit.
+\param hi [out] The hi unit of the product.
+\return The lo unit of the product.*/
+template<typename T>
+inline T MulUnit(const T a, const T b, T& hi)
+{
+	using PT = typename cg::PromoteType<T>::Type;
+	return MulUnit(a, b, hi,
+		std::integral_constant<bool, (sizeof(PT) > sizeof(T))>());
+}
+/**Divide a double unit by a unit without a promoted type.  The divisor is
+normalized and the quotient is found one half unit at a time.
+\param hi The hi unit of the dividend.  Must be less than d.
+\param lo The lo unit of the dividend.
+\param d The divisor.
+\param rem [out] The remainder.
+\return The quotient.*/
+template<typename T>
+inline T DivUnit(T hi, T lo, T d, T& rem, std::false_type)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	const std::size_t H = TBits / 2;
+	const T B = T(T(1) << H);
+	const T M = T(B - 1);
+	const std::size_t sh = TBits - MSBNumber(&d, 1);
+	if (sh)
+	{
+		d = T(d << sh);
+		hi = T(T(hi << sh) | T(lo >> (TBits - sh)));
+		lo = T(lo << sh);
+	}
+	const T d1 = T(d >> H), d0 = T(d & M);
+	const T l1 = T(lo >> H), l0 = T(lo & M);
+	T q1 = T(hi / d1);
+	T rhat = T(hi - q1 * d1);
+	while (q1 >= B || T(q1 * d0) > T(T(rhat << H) | l1))
+	{
+		--q1;
+		rhat = T(rhat + d1);
+		if (rhat >= B)
+			break;
+	}
+	const T mid = T(T(hi << H) + l1 - T(q1 * d));
+	T q0 = T(mid / d1);
+	rhat = T(mid - q0 * d1);
+	while (q0 >= B || T(q0 * d0) > T(T(rhat << H) | l0))
+	{
+		--q0;
+		rhat = T(rhat + d1);
+		if (rhat >= B)
+			break;
+	}
+	rem = T(T(T(mid << H) + l0 - T(q0 * d)) >> sh);
+	return T(T(q1 << H) | q0);
+}
+#if defined(_MSC_VER) && _MSC_VER >= 1920 && defined(_M_X64) \
+	&& !defined(__SIZEOF_INT128__)
+/**\sa DivUnit*/
+template<>
+inline uint64_t DivUnit<uint64_t>(uint64_t hi, uint64_t lo, uint64_t d,
+	uint64_t& rem, std::false_type)
+{
+	unsigned __int64 r;
+	const uint64_t q = _udiv128(hi, lo, d, &r);
+	rem = r;
+	return q;
+}
+#endif
+/**Divide a double unit by a unit using the promoted type.
+\param hi The hi unit of the dividend.  Must be less than d.
+\param lo The lo unit of the dividend.
+\param d The divisor.
+\param rem [out] The remainder.
+\return The quotient.*/
+template<typename T>
+inline T DivUnit(const T hi, const T lo, const T d, T& rem, std::true_type)
+{
+	using PT = typename cg::PromoteType<T>::Type;
+	const PT n = PT(PT(hi) << (sizeof(T) * 8)) | lo;
+	const T q = T(n / d);
+	rem = T(n - PT(q) * d);
+	return q;
+}
+/**Divide a double unit by a unit.
+\param hi The hi unit of the dividend.  Must be less than d.
+\param lo The lo unit of the dividend.
+\param d The divisor.
+\param rem [out] The remainder.
+\return The quotient.*/
+template<typename T>
+inline T DivUnit(const T hi, const T lo, const T d, T& rem)
+{
+	using PT = typename cg::PromoteType<T>::Type;
+	return DivUnit(hi, lo, d, rem,
+		std::integral_constant<bool, (sizeof(PT) > sizeof(T))>());
+}
+/**Find the reciprocal of a normalized unit for DivUnitPre.
+\param d The divisor.  The high bit must be set.
+\return floor((B^2 - 1) / d) - B, where B is the unit base.*/
+template<typename T>
+inline T ReciprocalUnit(const T d)
+{
+	T rem;
+	return DivUnit(T(~d), T(~T(0)), d, rem);
+}
+/**Divide a double unit by a normalized unit with a precomputed reciprocal
+(Moller and Granlund, "Improved division by invariant integers").  Only
+multiplications and a couple of rare corrections are done.
+\param hi The hi unit of the dividend.  Must be less than d.
+\param lo The lo unit of the dividend.
+\param d The divisor.  The high bit must be set.
+\param v The reciprocal of d from ReciprocalUnit.
+\param rem [out] The remainder.
+\return The quotient.*/
+template<typename T>
+inline T DivUnitPre(const T hi, const T lo, const T d, const T v, T& rem)
+{
+	T q1;
+	T q0 = MulUnit(v, hi, q1);
+	q1 = T(q1 + AddCarry<T>(0, q0, lo, q0) + hi + 1);
+	/*Only the low unit of q1 d is needed.*/
+	T t;
+	T r = T(lo - MulUnit(q1, d, t));
+	if (r > q0)
+	{
+		--q1;
+		r = T(r + d);
+	}
+	if (r >= d)
+	{
+		++q1;
+		r = T(r - d);
+	}
+	rem = r;
+	return q1;
+}
 /**Set an array to zero.
 \param arr The array.
 \param s The size of the array.*/
@@ -84,6 +348,18 @@ inline bool IsOne(const cg::ArrayView<T>& arr)
 {
 	return IsOne(arr.Begin(), arr.Size());
 }
+/**Get the size of an array without the MSD side zeros.
+\param arr The array.
+\param s The size of the array.
+\return The amount of units up to and including the most significant non
+zero unit.  Zero if the array is zero.*/
+template<typename T>
+inline std::size_t RealSize(const T* arr, std::size_t s)
+{
+	while (s != 0 && arr[s - 1] == 0)
+		--s;
+	return s;
+}
 /**Compare two objects.  This function assumes that there are no leading zeros
 that do not effect the value of the function.
 \param arr1 The first array.
@@ -135,28 +411,25 @@ adjacent pointers up to the amount in s1.
 \param s1 the max size of arr1.
 \param arr2 The second array.
 \param s2 The max size of r2.
-\return false always.*/
+\return True if a carry went past the end of arr1.*/
 template<typename T>
 inline bool AddArray(T* arr1, const std::size_t s1, 
 	const T* arr2, const std::size_t s2)
 {
-	auto & l = *arr1;
-	auto & r = *arr2;
-	l += r;
-	if (l < r && s1 != 1)
-	{
-		T t(1);
-		AddArray(arr1 + 1, s1 - 1, &t, 1);
-	}
-	if (s2 != 1 && s1 != 1)
-		AddArray(arr1 + 1, s1 - 1, arr2 + 1, s2 - 1);
-	return false;
+	const std::size_t n = s1 < s2 ? s1 : s2;
+	unsigned char carry = 0;
+	std::size_t i = 0;
+	for (; i < n; ++i)
+		carry = AddCarry(carry, arr1[i], arr2[i], arr1[i]);
+	for (; carry && i < s1; ++i)
+		carry = AddCarry(carry, arr1[i], T(0), arr1[i]);
+	return carry != 0;
 }
 /**Array adding function.  The carry will propagate over
 adjacent pointers up to the amount in s1.
 \param arr1 The first array.
 \param arr2 The second array.
-\return false always.*/
+\return True if a carry went past the end of arr1.*/
 template<typename T>
 inline bool AddArray(cg::ArrayView<T>& arr1, const cg::ArrayView<T>& arr2)
 {
@@ -165,19 +438,21 @@ inline bool AddArray(cg::ArrayView<T>& arr1, const cg::ArrayView<T>& arr2)
 /**Add a single num to the array.
 \param arr The array.
 \param s The size of the array.
-\param n A number to add to the array.*/
+\param n A number to add to the array.
+\return True if a carry went past the end of arr.*/
 template<typename T>
-inline void AddArray(T* arr, const std::size_t s, const T& n)
+inline bool AddArray(T* arr, const std::size_t s, const T& n)
 {
-	AddArray(arr, s, &n, 1);
+	return AddArray(arr, s, &n, 1);
 }
 /**Add a single num to the array.
 \param arr The array.
-\param n A number to add to the array.*/
+\param n A number to add to the array.
+\return True if a carry went past the end of arr.*/
 template<typename T>
-inline void AddArray(cg::ArrayView<T>& arr, const T& n)
+inline bool AddArray(cg::ArrayView<T>& arr, const T& n)
 {
-	AddArray(arr.Begin(), arr.Size(), n);
+	return AddArray(arr.Begin(), arr.Size(), n);
 }
 /**The sub function.  The borrow will propagate over
 adjacent pointers up to the amount in s1.
@@ -185,36 +460,26 @@ adjacent pointers up to the amount in s1.
 \param s1 the max size of arr1.
 \param arr2 The second array.
 \param s2 The max size of r2.
-\return True if the result went below zero. False if its still > 0.*/
+\return True if the result went below zero. False if its still >= 0.*/
 template<typename T>
 inline bool SubArray(T* arr1, const std::size_t s1,
 	const T* arr2, const std::size_t s2)
 {
-	auto & l = *arr1;
-	bool doCarry = *arr2 > l;
-	auto r = cg::TwoComp(*arr2);
-	if (r != 0)
-	{
-		l += r;
-		if (doCarry)
-		{
-			T t(1);
-			/*supress the carry with size 1 for arr1.  We ignore the carry when
-			`subbing` the `1` while in twos comp form.*/
-			SubArray(arr1 + 1, 1, &t, 1);
-		}
-	}
-	if (s2 != 1 && s1 != 1)
-		SubArray(arr1 + 1, s1 - 1, arr2 + 1, s2 - 1);
-
-	return false;
+	const std::size_t n = s1 < s2 ? s1 : s2;
+	unsigned char borrow = 0;
+	std::size_t i = 0;
+	for (; i < n; ++i)
+		borrow = SubBorrow(borrow, arr1[i], arr2[i], arr1[i]);
+	for (; borrow && i < s1; ++i)
+		borrow = SubBorrow(borrow, arr1[i], T(0), arr1[i]);
+	return borrow != 0;
 }
 
 /**The sub function.  The borrow will propagate over
 adjacent pointers up to the amount in s1.
 \param arr1 The first array.
 \param arr2 The second array.
-\return True if the result went below zero. False if its still > 0.*/
+\return True if the result went below zero. False if its still >= 0.*/
 template<typename T>
 inline bool SubArray(cg::ArrayView<T>& arr1, const cg::ArrayView<T>& arr2)
 {
@@ -223,195 +488,1184 @@ inline bool SubArray(cg::ArrayView<T>& arr1, const cg::ArrayView<T>& arr2)
 /**Sub a single num from the array.
 \param arr The array.
 \param s The size of the array.
-\param n A number to sub from the array.*/
+\param n A number to sub from the array.
+\return True if the result went below zero.*/
 template<typename T>
-inline void SubArray(T* arr, const std::size_t s, const T& n)
+inline bool SubArray(T* arr, const std::size_t s, const T& n)
 {
-	SubArray(arr, s, &n, 1);
+	return SubArray(arr, s, &n, 1);
 }
 /**Sub a single num from the array.
 \param arr The array.
-\param n A number to sub from the array.*/
+\param n A number to sub from the array.
+\return True if the result went below zero.*/
 template<typename T>
-inline void SubArray(cg::ArrayView<T>& arr, const T& n)
+inline bool SubArray(cg::ArrayView<T>& arr, const T& n)
 {
-	SubArray(arr.Begin(), arr.Size(), n);
+	return SubArray(arr.Begin(), arr.Size(), n);
 }
-/**The mult function.  The borrow will propagate over
-adjacent pointers up to the amount in s1.  Should be called with T = a type
-that is half the size of the actual type.
-\param arr1 The first array.
-\param s1p the max size of arr1.
-\param arr2 The second array.
-\param s2p The max size of r2.
-\return false always.*/
+/**Multiply two units and add a carry unit without a promoted type.
+\param a The first unit of the product.
+\param m The second unit of the product.
+\param carry The carry unit to add.
+\param hi [out] The hi unit of the result.
+\return The lo unit of the result.*/
 template<typename T>
-inline bool MulArray(T* arr1, const  std::size_t s1p,
-	const T* arr2, const std::size_t s2p)
+inline T MulAddUnit(const T a, const T m, const T carry, T& hi,
+	std::false_type)
 {
-	static_assert(sizeof(T) > 1, "T must be at least 2 bytes long.");
-	using DT = typename cg::DemoteType<T>::Type;
-	/*The arrays are casted to half the size type, so double the amount of
-	units.*/
-	const std::size_t s1 = s1p + s1p;
-	const std::size_t s2 = s2p + s2p;
-	DT* tArr = new DT[s1]();
-
-	for (std::size_t i = 0; i < s1; ++i)
+	T lo = MulUnit(a, m, hi);
+	hi += AddCarry<T>(0, lo, carry, lo);
+	return lo;
+}
+/**Multiply two units and add a carry unit using the promoted type.
+\param a The first unit of the product.
+\param m The second unit of the product.
+\param carry The carry unit to add.
+\param hi [out] The hi unit of the result.
+\return The lo unit of the result.*/
+template<typename T>
+inline T MulAddUnit(const T a, const T m, const T carry, T& hi,
+	std::true_type)
+{
+	using PT = typename cg::PromoteType<T>::Type;
+	const PT t = PT(a) * PT(m) + carry;
+	hi = T(t >> (sizeof(T) * 8));
+	return T(t);
+}
+/**Multiply two units and add a carry unit.
+\param a The first unit of the product.
+\param m The second unit of the product.
+\param carry The carry unit to add.
+\param hi [out] The hi unit of the result.
+\return The lo unit of the result.*/
+template<typename T>
+inline T MulAddUnit(const T a, const T m, const T carry, T& hi)
+{
+	using PT = typename cg::PromoteType<T>::Type;
+	return MulAddUnit(a, m, carry, hi,
+		std::integral_constant<bool, (sizeof(PT) > sizeof(T))>());
+}
+/**Multiply an array by a single unit in place.
+\param arr The array.
+\param s The size of the array.
+\param n The unit to multiply by.
+\return The carry unit that did not fit in arr.*/
+template<typename T>
+inline T MulArray(T* arr, const std::size_t s, const T& n)
+{
+	/*n may be a unit of arr.*/
+	const T m = n;
+	T carry = 0;
+	std::size_t i = 0;
+	for (; i + 4 <= s; i += 4)
 	{
-		for (std::size_t j = 0; j < s2; ++j)
-		{
-			T t = T(((DT*)arr1)[i]) * ((DT*)arr2)[j];
-			if(t != 0)
-				AddArray(tArr + i + j, s1 - i - j, (DT*)&t, 2);
-		}
+		arr[i] = MulAddUnit(arr[i], m, carry, carry);
+		arr[i + 1] = MulAddUnit(arr[i + 1], m, carry, carry);
+		arr[i + 2] = MulAddUnit(arr[i + 2], m, carry, carry);
+		arr[i + 3] = MulAddUnit(arr[i + 3], m, carry, carry);
 	}
-
-	std::memmove(arr1, tArr, s1 * sizeof(DT));
-	delete[] tArr;
-	return false;
+	for (; i < s; ++i)
+		arr[i] = MulAddUnit(arr[i], m, carry, carry);
+	return carry;
 }
-/**The mult function.  The borrow will propagate over
-adjacent pointers up to the amount in s1.  Should be called with T = a type
-that is half the size of the actual type.
-\param arr1 The first array.
-\param arr2 The second array.
-\return false always.*/
+/**Add the product of two units and a carry unit to a unit without a
+promoted type.
+\param r The unit to add to.  Will be the lo unit of the sum.
+\param a The first unit of the product.
+\param m The second unit of the product.
+\param carry The carry unit to add.
+\return The hi unit of the sum.*/
 template<typename T>
-inline bool MulArray(cg::ArrayView<T>& arr1, const cg::ArrayView<T>& arr2)
+inline T AddMulUnit(T& r, const T a, const T m, const T carry,
+	std::false_type)
 {
-	return MulArray(arr1.Begin(), arr1.Size(), arr2.Begin(), arr2.Size());
+	T hi;
+	const T lo = MulAddUnit(a, m, carry, hi, std::false_type());
+	return T(hi + AddCarry<T>(0, r, lo, r));
 }
-/**Iteger power function.
-\param num A reference to the number to apply to the power.
-\param exp The exponent to apply.
-\return A reference to num*/
+/**Add the product of two units and a carry unit to a unit using the
+promoted type.  The sum is at most B^2 - 1 so it always fits.
+\param r The unit to add to.  Will be the lo unit of the sum.
+\param a The first unit of the product.
+\param m The second unit of the product.
+\param carry The carry unit to add.
+\return The hi unit of the sum.*/
 template<typename T>
-inline T& PowInPlace(T& num, std::size_t exp)
+inline T AddMulUnit(T& r, const T a, const T m, const T carry,
+	std::true_type)
 {
-	if (exp == 0)
+	using PT = typename cg::PromoteType<T>::Type;
+	const PT t = PT(a) * PT(m) + r + carry;
+	r = T(t);
+	return T(t >> (sizeof(T) * 8));
+}
+/**Add the product of two units and a carry unit to a unit.
+\param r The unit to add to.  Will be the lo unit of the sum.
+\param a The first unit of the product.
+\param m The second unit of the product.
+\param carry The carry unit to add.
+\return The hi unit of the sum.*/
+template<typename T>
+inline T AddMulUnit(T& r, const T a, const T m, const T carry)
+{
+	using PT = typename cg::PromoteType<T>::Type;
+	return AddMulUnit(r, a, m, carry,
+		std::integral_constant<bool, (sizeof(PT) > sizeof(T))>());
+}
+/**Add an array times a unit to another array in one pass, the inner loop of
+the quadratic multiplication, division and reduction functions.
+\param r The array to add to.  Has n units, the carry out is returned.  May
+be the same array as a.
+\param a The array to multiply.
+\param n The size of a.
+\param m The unit to multiply by.
+\return The carry unit that did not fit in r.*/
+template<typename T>
+inline T AddMulArray(T* r, const T* a, const std::size_t n, const T m)
+{
+	T carry = 0;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
 	{
-		num = 1;
-		return num;
+		carry = AddMulUnit(r[i], a[i], m, carry);
+		carry = AddMulUnit(r[i + 1], a[i + 1], m, carry);
+		carry = AddMulUnit(r[i + 2], a[i + 2], m, carry);
+		carry = AddMulUnit(r[i + 3], a[i + 3], m, carry);
 	}
-	T base = num;
-	num = 1;
-	while (exp)
+	for (; i < n; ++i)
+		carry = AddMulUnit(r[i], a[i], m, carry);
+	return carry;
+}
+/**Subtract an array times a unit from another array in one pass.
+\param r The array to subtract from.  Has n units, the borrow out is
+returned.  May be the same array as a.
+\param a The array to multiply.
+\param n The size of a.
+\param m The unit to multiply by.
+\return The unit to subtract from the unit past the end of r.*/
+template<typename T>
+inline T SubMulArray(T* r, const T* a, const std::size_t n, const T m)
+{
+	/*The product's carries and the borrows are kept apart so the two chains
+	do not wait on each other.*/
+	T carry = 0;
+	unsigned char borrow = 0;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4)
 	{
-		if (exp & 1)
-			num *= base;
-		exp >>= 1;
-		base *= base;
+		borrow = SubBorrow(borrow, r[i], MulAddUnit(a[i], m, carry, carry),
+			r[i]);
+		borrow = SubBorrow(borrow, r[i + 1],
+			MulAddUnit(a[i + 1], m, carry, carry), r[i + 1]);
+		borrow = SubBorrow(borrow, r[i + 2],
+			MulAddUnit(a[i + 2], m, carry, carry), r[i + 2]);
+		borrow = SubBorrow(borrow, r[i + 3],
+			MulAddUnit(a[i + 3], m, carry, carry), r[i + 3]);
 	}
-	return num;
-
+	for (; i < n; ++i)
+		borrow = SubBorrow(borrow, r[i], MulAddUnit(a[i], m, carry, carry),
+			r[i]);
+	return T(carry + borrow);
 }
-/**Shift an array to its maximum value while staying less than some other num.
-\param arr1 The array that will be shifted.
-\param s1 The size of arr1.
-\param arr2 The second array that will remain larger than arr1.
-\param s2 The size of the second array.
-\param max The total amount of shifts that may be made.
-\return The amount of shifts made on arr1.*/
+/**AddMulArray for 64 bit units, done by the kernel picked for the CPU, see
+Kernels.  Short arrays skip the indirect call.*/
+inline uint64_t AddMulArray(uint64_t* r, const uint64_t* a,
+	const std::size_t n, const uint64_t m)
+{
+	if (n < 4)
+		return AddMulArray<uint64_t>(r, a, n, m);
+	return Kernels::AddMul(r, a, n, m);
+}
+/**SubMulArray for 64 bit units, done by the kernel picked for the CPU, see
+Kernels.  Short arrays skip the indirect call.*/
+inline uint64_t SubMulArray(uint64_t* r, const uint64_t* a,
+	const std::size_t n, const uint64_t m)
+{
+	if (n < 4)
+		return SubMulArray<uint64_t>(r, a, n, m);
+	return Kernels::SubMul(r, a, n, m);
+}
+/**Multiply an array by a short array in place, without a temporary.  The
+units of arr are used from the top down, each one replaced by its product
+with b, so the cost is s * nb unit products.
+\param arr The array.  Will be the answer, truncated to s units.
+\param s The size of arr.
+\param b The array to multiply by.  Must not overlap arr.
+\param nb The size of b.
+\return True if the product did not fit in s units.*/
 template<typename T>
-inline std::size_t MaximumShift(T* arr1, const std::size_t s1, const T* arr2,
-	const std::size_t s2, const  std::size_t max)
+inline bool MulSmallInPlace(T* arr, const std::size_t s, const T* b,
+	std::size_t nb)
 {
-	if (max == 0)
+	nb = RealSize(b, nb);
+	const std::size_t na = RealSize(arr, s);
+	if (nb == 0)
+	{
+		ZeroOut(arr, na);
+		return false;
+	}
+	bool overflow = false;
+	for (std::size_t i = na; i-- > 0;)
+	{
+		const T m = arr[i];
+		arr[i] = 0;
+		if (m == 0)
+			continue;
+		const std::size_t room = s - i;
+		if (room < nb)
+		{/*The top unit of b times m lands past the end.*/
+			AddMulArray(arr + i, b, room, m);
+			overflow = true;
+			continue;
+		}
+		const T carry = AddMulArray(arr + i, b, nb, m);
+		if (room > nb)
+			overflow |= AddArray(arr + i + nb, room - nb, carry);
+		else
+			overflow |= carry != 0;
+	}
+	return overflow;
+}
+/**Divide an array by a single unit that is known to divide it exactly.  Uses
+the inverse of the odd part of d (mod the unit size) so no real division is
+done.
+\param arr The array.  Will be the quotient.
+\param s The size of the array.
+\param d The divisor.  Must not be zero and must divide arr exactly.*/
+template<typename T>
+inline void DivExactArray(T* arr, const std::size_t s, T d)
+{
+	std::size_t zeros = 0;
+	while ((d & 1) == 0)
+	{
+		d >>= 1;
+		++zeros;
+	}
+	ShiftInsigB(arr, s, zeros);
+	if (d == 1)
+		return;
+	/*d*d == 1 mod 8 for odd d, each newton step doubles the correct bits.
+	The low units of the products come from MulUnit, since small units would
+	be multiplied as signed ints.*/
+	T inv = d;
+	T hi;
+	for (std::size_t bits = 3; bits < sizeof(T) * 8; bits += bits)
+		inv = MulUnit(inv, T(T(2) - MulUnit(d, inv, hi)), hi);
+	T carry = 0;
+	for (std::size_t i = 0; i < s; ++i)
+	{
+		T x;
+		unsigned char borrow = SubBorrow<T>(0, arr[i], carry, x);
+		const T q = MulUnit(x, inv, hi);
+		arr[i] = q;
+		MulUnit(q, d, carry);
+		carry += borrow;
+	}
+}
+/**Divide an array by a single unit.  The divisor's reciprocal is found once
+so each unit of the quotient costs a few multiplications, and nothing is
+allocated.
+\param arr The array.  Will be the quotient.
+\param s The size of the array.
+\param d The divisor.
+\return The remainder.*/
+template<typename T>
+inline T DivArray(T* arr, const std::size_t s, const T& d)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	if (d == 0)
+		throw std::invalid_argument("Divisor is zero.");
+	if (s == 0)
 		return 0;
-	std::size_t msb_1 = MSBNumber(arr1, s1);
-	std::size_t msb_2 = MSBNumber(arr2, s2);
-	if (msb_1 < msb_2)
+	/*Divide arr * 2^sh by d * 2^sh, so the divisor is normalized.*/
+	const std::size_t sh = TBits - MSBNumber(&d, 1);
+	const T dn = T(d << sh);
+	const T v = ReciprocalUnit(dn);
+	T r = 0;
+	if (sh == 0)
 	{
-		std::size_t shiftAmt = (msb_2 - 1) - msb_1;
-		shiftAmt = shiftAmt <= max ? shiftAmt : max;
-		ShiftSigB(arr1, s1, shiftAmt);
-		return shiftAmt;
+		for (std::size_t i = s; i-- > 0;)
+			arr[i] = DivUnitPre(r, arr[i], dn, v, r);
+		return r;
 	}
-	else if (msb_1 > msb_2)
+	r = T(arr[s - 1] >> (TBits - sh));
+	for (std::size_t i = s - 1; i > 0; --i)
 	{
-		std::size_t shiftAmt = (msb_1)-(msb_2 - 1);
-		shiftAmt = shiftAmt <= max ? shiftAmt : max;
-		ShiftInsigB(arr1, s1, shiftAmt);
-		return shiftAmt;
+		const T u = T(T(arr[i] << sh) | T(arr[i - 1] >> (TBits - sh)));
+		arr[i] = DivUnitPre(r, u, dn, v, r);
 	}
-	/*both are the same msb*/
-	std::size_t shiftAmt = 1;
-	shiftAmt = shiftAmt <= max ? shiftAmt : max;
-	ShiftInsigB(arr1, s1, shiftAmt);
-	return shiftAmt;
+	arr[0] = DivUnitPre(r, T(arr[0] << sh), dn, v, r);
+	return T(r >> sh);
 }
-/**Shift an array to its maximum value while staying less than some other num.
-\param arr1 The array that will be shifted.
-\param arr2 The second array that will remain larger than arr1.
-\param max The total amount of shifts that may be made.
-\return The amount of shifts made on arr1.*/
+/**Find the remainder of an array divided by a single unit, with the
+divisor's reciprocal found ahead of time.  The array is not changed.
+\param arr The array.
+\param s The size of the array.
+\param dn The divisor shifted up until its high bit is set.
+\param v The reciprocal of dn from ReciprocalUnit.
+\param sh The amount the divisor was shifted.
+\return The remainder.*/
 template<typename T>
-inline std::size_t MaximumShift(cg::ArrayView<T>& arr1,
-	const cg::ArrayView<T>& arr2, const std::size_t max)
+inline T ModArrayPre(const T* arr, const std::size_t s, const T dn, const T v,
+	const std::size_t sh)
 {
-	return MaximumShift(arr1.Begin(), arr1.Size(),
-		arr2.Begin(), arr2.Size(), max);
+	const std::size_t TBits = sizeof(T) * 8;
+	if (s == 0)
+		return 0;
+	T r = 0;
+	if (sh == 0)
+	{
+		for (std::size_t i = s; i-- > 0;)
+			DivUnitPre(r, arr[i], dn, v, r);
+		return r;
+	}
+	r = T(arr[s - 1] >> (TBits - sh));
+	for (std::size_t i = s - 1; i > 0; --i)
+		DivUnitPre(r, T(T(arr[i] << sh) | T(arr[i - 1] >> (TBits - sh))), dn,
+			v, r);
+	DivUnitPre(r, T(arr[0] << sh), dn, v, r);
+	return T(r >> sh);
 }
-/**The basic division function.  This function assumes there are no MSB zeros.
-\param arr1 The first dividend array.  Will be the answer after the function
-returnes.
-\param s1 The size of the first array.
-\param arr2 The second divisor array.
-\param s2 The size of the second array.
-\param arr3 The third array that will hold the modulo of the operation. If its
-nullptr (or 0) it will be ignored.  If its not false, it must be the same size
-as s1.*/
+/**Find the remainder of an array divided by a single unit.  The array is not
+changed and nothing is allocated.
+\param arr The array.
+\param s The size of the array.
+\param d The divisor.
+\return The remainder.*/
 template<typename T>
-inline void DivArray_Shift(T* arr1, const std::size_t s1, const T* arr2,
-	const std::size_t s2, T* arr3)
+inline T ModArray(const T* arr, const std::size_t s, const T& d)
 {
-	static_assert(sizeof(T) > 1, "T must be at least 2 bytes long.");
-	const static T TMax = std::numeric_limits<T>::max();
-	const std::size_t s1T = s1 * sizeof(T);
-	if ((s1 == 1) && (s2 == 1))
+	const std::size_t TBits = sizeof(T) * 8;
+	if (d == 0)
+		throw std::invalid_argument("Divisor is zero.");
+	const std::size_t sh = TBits - MSBNumber(&d, 1);
+	const T dn = T(d << sh);
+	return ModArrayPre(arr, s, dn, ReciprocalUnit(dn), sh);
+}
+/**The type of the out-of-place multiplication kernels.*/
+template<typename T>
+using MulKernelPtr = void(*)(T*, const T*, const std::size_t, const T*,
+	const std::size_t);
+
+template<typename T>
+inline void MulArray(T* r, const T* a, const std::size_t na,
+	const T* b, const std::size_t nb);
+template<typename T>
+inline void SqrArray(T* r, const T* a, const std::size_t n);
+
+/**Schoolbook multiplication.
+\param r [out] The product.  Must have room for na + nb units and must not
+overlap a or b.
+\param a The first array.
+\param na The size of a.
+\param b The second array.
+\param nb The size of b.*/
+template<typename T>
+inline void MulArray_School(T* r, const T* a, const std::size_t na,
+	const T* b, const std::size_t nb)
+{
+	ZeroOut(r, na + nb);
+	for (std::size_t i = 0; i < nb; ++i)
+		r[i + na] = AddMulArray(r + i, a, na, b[i]);
+}
+/**Karatsuba multiplication.  Sub products are done with MulArray so that
+they may use any algorithm.
+\param r [out] The product.  Must have room for na + nb units and must not
+overlap a or b.
+\param a The first array.
+\param na The size of a.  Must be >= nb.
+\param b The second array.
+\param nb The size of b.*/
+template<typename T>
+inline void MulArray_Karatsuba(T* r, const T* a, const std::size_t na,
+	const T* b, const std::size_t nb)
+{
+	const std::size_t h = (na + 1) / 2;
+	const std::size_t sr = na + nb;
+	if (nb <= h)
+	{/*b has no hi half: r = a0*b + a1*b*B^h.*/
+		T* t = new T[na - h + nb];
+		MulArray(r, a, h, b, nb);
+		ZeroOut(r + h + nb, sr - h - nb);
+		MulArray(t, a + h, na - h, b, nb);
+		AddArray(r + h, sr - h, t, na - h + nb);
+		delete[] t;
+		return;
+	}
+	const std::size_t z1Size = h + h + 2;
+	T* sa = new T[h + 1 + h + 1 + z1Size];
+	T* sb = sa + h + 1;
+	T* z1 = sb + h + 1;
+	/*sa = a0 + a1, sb = b0 + b1*/
+	std::memcpy(sa, a, h * sizeof(T));
+	sa[h] = 0;
+	AddArray(sa, h + 1, a + h, na - h);
+	std::memcpy(sb, b, h * sizeof(T));
+	sb[h] = 0;
+	AddArray(sb, h + 1, b + h, nb - h);
+	/*z0 and z2 go straight to the answer.*/
+	MulArray(r, a, h, b, h);
+	MulArray(r + h + h, a + h, na - h, b + h, nb - h);
+	/*z1 = sa*sb - z0 - z2*/
+	MulArray(z1, sa, h + 1, sb, h + 1);
+	SubArray(z1, z1Size, r, h + h);
+	SubArray(z1, z1Size, r + h + h, sr - h - h);
+	AddArray(r + h, sr - h, z1, RealSize(z1, z1Size));
+	delete[] sa;
+}
+/**Add a signed array to another signed array.  Both have the same size and
+are stored as a magnitude and a sign.
+\param r The array to add to.  Will be the answer.
+\param rNeg The sign of r.  True if r is negative.
+\param a The array to add.
+\param aNeg The sign of a.  True if a is negative.
+\param s The size of both arrays.*/
+template<typename T>
+inline void AddSignedArray(T* r, bool& rNeg, const T* a, const bool aNeg,
+	const std::size_t s)
+{
+	if (rNeg == aNeg)
 	{
-		if (arr3)
-			*arr3 = *arr1;
-		*arr1 /= *arr2;
-		if (arr3)
-			*arr3 %= *arr2;
+		AddArray(r, s, a, s);
 		return;
 	}
-	if (IsZero(arr2, s2))
-		throw std::invalid_argument("Divisor is zero.");
-	if (IsOne(arr2, s2))
+	if (CompareArray(r, s, a, s) >= 0)
 	{
-		if (arr3)
-			ZeroOut(arr3, s1);
+		SubArray(r, s, a, s);
 		return;
 	}
-	bool cleanArr3 = false;
-	if (!arr3)
+	/*|a| > |r|, r = a - r*/
+	unsigned char borrow = 0;
+	for (std::size_t i = 0; i < s; ++i)
+		borrow = SubBorrow(borrow, a[i], r[i], r[i]);
+	rNeg = aNeg;
+}
+/**Toom-Cook multiplication.  The operands are split in to k pieces and the
+product polynomial is evaluated at 0, 1, -1, 2, -2, 3... and infinity.  The
+coefficients are recovered with newton divided differences, which are exact
+integer divisions by small numbers.  Sub products are done with MulArray so
+they may use any algorithm.
+\param r [out] The product.  Must have room for na + nb units and must not
+overlap a or b.
+\param a The first array.
+\param na The size of a.  Must be >= nb.
+\param b The second array.
+\param nb The size of b.
+\param k The amount of pieces.  Must be 3 or 4.*/
+template<typename T>
+inline void MulArray_Toom(T* r, const T* a, const std::size_t na,
+	const T* b, const std::size_t nb, const std::size_t k)
+{
+	const std::size_t m = (na + k - 1) / k;
+	const std::size_t sr = na + nb;
+	/*Squares only need one operand evaluated.*/
+	const bool square = a == b && na == nb;
+	/*The amount of finite points.*/
+	const std::size_t np = k + k - 2;
+	/*The size of the temp values.  The values and the divided differences
+	stay under 2^24 * B^(2m).*/
+	const std::size_t L = m + m + 4;
+	long x[6];
+	for (std::size_t j = 0; j < np; ++j)
+		x[j] = (j & 1) ? long(j + 1) / 2 : -long(j / 2);
+	/*w holds the point values, c the coefficients, va and vb the evaluated
+	operands and t is scratch.*/
+	T* w = new T[(np + np + 3) * L];
+	T* c = w + np * L;
+	T* va = c + np * L;
+	T* vb = va + L;
+	T* t = vb + L;
+	bool wNeg[6];
+	bool cNeg[6];
+	/*The piece sizes.*/
+	auto pieceA = [&](std::size_t i) {
+		return i * m >= na ? 0 : ((na - i * m) < m ? na - i * m : m); };
+	auto pieceB = [&](std::size_t i) {
+		return i * m >= nb ? 0 : ((nb - i * m) < m ? nb - i * m : m); };
+	/*Evaluate both operands at each point with horners method and multiply
+	the values.*/
+	for (std::size_t j = 0; j < np; ++j)
 	{
-		arr3 = new T[s1];
-		cleanArr3 = true;
+		const T ax = T(x[j] < 0 ? -x[j] : x[j]);
+		bool aNeg = false;
+		bool bNeg = false;
+		ZeroOut(va, L);
+		ZeroOut(vb, L);
+		for (std::size_t i = k; i-- > 0;)
+		{
+			MulArray(va, L, ax);
+			MulArray(vb, L, ax);
+			if (x[j] < 0)
+			{
+				aNeg = !aNeg;
+				bNeg = !bNeg;
+			}
+			if (pieceA(i))
+			{
+				ZeroOut(t, L);
+				std::memcpy(t, a + i * m, pieceA(i) * sizeof(T));
+				AddSignedArray(va, aNeg, t, false, L);
+			}
+			if (pieceB(i) && !square)
+			{
+				ZeroOut(t, L);
+				std::memcpy(t, b + i * m, pieceB(i) * sizeof(T));
+				AddSignedArray(vb, bNeg, t, false, L);
+			}
+		}
+		T* wj = w + j * L;
+		const std::size_t ra = RealSize(va, L);
+		const std::size_t rb = RealSize(vb, L);
+		ZeroOut(wj, L);
+		if (square)
+			SqrArray(wj, va, ra);
+		else
+			MulArray(wj, va, ra, vb, rb);
+		wNeg[j] = square ? false : aNeg != bNeg;
 	}
-	/*move the contents of array-1 into array-3 so that it contains the answer
-	when all is said and done.*/
-	std::memmove(arr3, arr1, s1 * sizeof(T));
-	/**arr1 will be the counter (and then the answer when done).*/
-	std::memset(arr1, 0, s1 * sizeof(T));
-	T* answerCounter = arr1;
-	T* dividend = arr3;
-	T* divisor = new T[s1]();
-	std::memmove(divisor, arr2, s2 * sizeof(T));
-	auto compareResult = CompareArray(dividend, s1, divisor, s1);
-	if (compareResult == 0)
-	{/*Both oprands are the same, answer = 1, modulo = 0 (already moved
-	 to the right spots by this line).*/
-		answerCounter[0] = 1;
-		std::memset(dividend, 0, s1T);
+	/*The point at infinity is the product of the top pieces.*/
+	T* top = t;
+	ZeroOut(top, L);
+	MulArray(top, a + (k - 1) * m, pieceA(k - 1), b + (k - 1) * m,
+		pieceB(k - 1));
+	/*Take the top coefficient out of the values so that np points are enough
+	for the rest.  w[j] -= top * x[j]^(np).*/
+	for (std::size_t j = 1; j < np; ++j)
+	{
+		T* cj = c;
+		std::memcpy(cj, top, L * sizeof(T));
+		const T ax = T(x[j] < 0 ? -x[j] : x[j]);
+		for (std::size_t e = 0; e < np; ++e)
+			MulArray(cj, L, ax);
+		AddSignedArray(w + j * L, wNeg[j], cj, true, L);
 	}
-	/*arr1 is larger, can do some math here.*/
-	auto shifted = MaximumShift(divisor, s1, dividend, s1, TMax);
-	compareResult = CompareArray(dividend, s1, divisor, s1);
-	while (compareResult == 1)
+	/*Divided differences.  w[j] becomes the newton coefficient f[x0..xj].*/
+	for (std::size_t l = 1; l < np; ++l)
+	{
+		for (std::size_t j = np - 1; j >= l; --j)
+		{
+			T* wj = w + j * L;
+			AddSignedArray(wj, wNeg[j], w + (j - 1) * L, !wNeg[j - 1], L);
+			const long d = x[j] - x[j - l];
+			DivExactArray(wj, L, T(d < 0 ? -d : d));
+			if (d < 0)
+				wNeg[j] = !wNeg[j];
+		}
+	}
+	/*Newton form to coefficients.  c = c*(x - x[j]) + w[j].*/
+	ZeroOut(c, np * L);
+	for (std::size_t i = 0; i < np; ++i)
+		cNeg[i] = false;
+	for (std::size_t j = np; j-- > 0;)
+	{
+		const T ax = T(x[j] < 0 ? -x[j] : x[j]);
+		/*c = c*x - c*x[j], done from the top down.*/
+		for (std::size_t i = np - 1; ; --i)
+		{
+			T* ci = c + i * L;
+			if (ax != 0)
+			{
+				MulArray(ci, L, ax);
+				if (x[j] > 0)
+					cNeg[i] = !cNeg[i];
+			}
+			else
+				ZeroOut(ci, L);
+			if (i == 0)
+				break;
+			AddSignedArray(ci, cNeg[i], ci - L, cNeg[i - 1], L);
+		}
+		AddSignedArray(c, cNeg[0], w + j * L, wNeg[j], L);
+	}
+	/*Put it all together.*/
+	ZeroOut(r, sr);
+	for (std::size_t i = 0; i <= np; ++i)
+	{
+		if (i * m >= sr)
+			break;
+		const T* ci = i == np ? top : c + i * L;
+		const std::size_t cs = RealSize(ci, L);
+		AddArray(r + i * m, sr - i * m, ci, cs < sr - i * m ? cs : sr - i * m);
+	}
+	delete[] w;
+}
+/**Toom-3 multiplication.
+\param r [out] The product.  Must have room for na + nb units and must not
+overlap a or b.
+\param a The first array.
+\param na The size of a.  Must be >= nb.
+\param b The second array.
+\param nb The size of b.*/
+template<typename T>
+inline void MulArray_Toom3(T* r, const T* a, const std::size_t na,
+	const T* b, const std::size_t nb)
+{
+	MulArray_Toom(r, a, na, b, nb, 3);
+}
+/**Toom-4 multiplication.
+\param r [out] The product.  Must have room for na + nb units and must not
+overlap a or b.
+\param a The first array.
+\param na The size of a.  Must be >= nb.
+\param b The second array.
+\param nb The size of b.*/
+template<typename T>
+inline void MulArray_Toom4(T* r, const T* a, const std::size_t na,
+	const T* b, const std::size_t nb)
+{
+	MulArray_Toom(r, a, na, b, nb, 4);
+}
+/**Raise a number to a power mod P.
+\tparam P The modulus.
+\param b The base.  Must be less than P.
+\param e The exponent.
+\return b^e mod P.*/
+template<uint32_t P>
+inline uint32_t PowModP(uint32_t b, uint64_t e)
+{
+	uint64_t r = 1;
+	uint64_t x = b;
+	for (; e; e >>= 1)
+	{
+		if (e & 1)
+			r = r * x % P;
+		x = x * x % P;
+	}
+	return uint32_t(r);
+}
+/**In place number theoretic transform mod P.
+\tparam P A prime of the form c*2^k + 1.
+\tparam G A primitive root of P.
+\param a The values.  Each must be less than P.
+\param n The amount of values.  Must be a power of two that divides P - 1.
+\param w Scratch space for n/2 values.
+\param inverse True to do the inverse transform, including the 1/n scale.*/
+template<uint32_t P, uint32_t G>
+inline void NTT(uint32_t* a, const std::size_t n, uint32_t* w,
+	const bool inverse)
+{
+	for (std::size_t i = 1, j = 0; i < n; ++i)
+	{
+		std::size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j)
+			std::swap(a[i], a[j]);
+	}
+	for (std::size_t len = 2; len <= n; len <<= 1)
+	{
+		const std::size_t half = len >> 1;
+		uint32_t root = PowModP<P>(G, (P - 1) / len);
+		if (inverse)
+			root = PowModP<P>(root, P - 2);
+		w[0] = 1;
+		for (std::size_t j = 1; j < half; ++j)
+			w[j] = uint32_t(uint64_t(w[j - 1]) * root % P);
+		for (std::size_t i = 0; i < n; i += len)
+		{
+			uint32_t* lo = a + i;
+			uint32_t* hi = lo + half;
+			for (std::size_t j = 0; j < half; ++j)
+			{
+				const uint32_t u = lo[j];
+				const uint32_t v = uint32_t(uint64_t(hi[j]) * w[j] % P);
+				lo[j] = u + v >= P ? u + v - P : u + v;
+				hi[j] = u >= v ? u - v : u + P - v;
+			}
+		}
+	}
+	if (inverse)
+	{
+		const uint64_t nInv = PowModP<P>(uint32_t(n % P), P - 2);
+		for (std::size_t i = 0; i < n; ++i)
+			a[i] = uint32_t(a[i] * nInv % P);
+	}
+}
+/**Get the cyclic convolution of the 16 bit pieces of two arrays mod P.
+\tparam P A prime of the form c*2^k + 1.
+\tparam G A primitive root of P.
+\param fa [out] The convolution.  Must have room for n values.
+\param fb Scratch space for n + n/2 values.
+\param n The transform size.
+\param a The first array.
+\param na The size of a.
+\param b The second array.
+\param nb The size of b.*/
+template<uint32_t P, uint32_t G, typename T>
+inline void NTTConvolve(uint32_t* fa, uint32_t* fb, const std::size_t n,
+	const T* a, const std::size_t na, const T* b, const std::size_t nb)
+{
+	const std::size_t pa = na * sizeof(T) / 2;
+	const std::size_t pb = nb * sizeof(T) / 2;
+	for (std::size_t i = 0; i < n; ++i)
+		fa[i] = i < pa ? uint32_t(ReadBits(a, na, i * 16, 16)) : 0;
+	NTT<P, G>(fa, n, fb + n, false);
+	if (a == b && na == nb)
+	{/*A square only needs the one transform.*/
+		for (std::size_t i = 0; i < n; ++i)
+			fa[i] = uint32_t(uint64_t(fa[i]) * fa[i] % P);
+	}
+	else
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			fb[i] = i < pb ? uint32_t(ReadBits(b, nb, i * 16, 16)) : 0;
+		NTT<P, G>(fb, n, fb + n, false);
+		for (std::size_t i = 0; i < n; ++i)
+			fa[i] = uint32_t(uint64_t(fa[i]) * fb[i] % P);
+	}
+	NTT<P, G>(fa, n, fb + n, true);
+}
+/**Multiplication with a number theoretic transform.  The operands are cut in
+to 16 bit pieces and convolved mod three primes.  Each convolution value is
+less than 2^56 so the chinese remainder of the three is found exactly with
+64 bit math.  Operands too large for the transform are given to Toom-4, which
+will come back here with smaller pieces.
+\param r [out] The product.  Must have room for na + nb units and must not
+overlap a or b.
+\param a The first array.
+\param na The size of a.
+\param b The second array.
+\param nb The size of b.*/
+template<typename T>
+inline void MulArray_NTT(T* r, const T* a, const std::size_t na,
+	const T* b, const std::size_t nb)
+{
+	static_assert(sizeof(T) > 1, "T must be at least 2 bytes long.");
+	const uint32_t P0 = 469762049;	/*7 * 2^26 + 1*/
+	const uint32_t P1 = 167772161;	/*5 * 2^25 + 1*/
+	const uint32_t P2 = 754974721;	/*45 * 2^24 + 1*/
+	const std::size_t maxN = std::size_t(1) << 24;
+	const std::size_t sr = na + nb;
+	const std::size_t pr = sr * sizeof(T) / 2;
+	std::size_t n = 1;
+	while (n < pr)
+		n <<= 1;
+	if (n > maxN)
+	{
+		MulArray_Toom4(r, a, na, b, nb);
+		return;
+	}
+	uint32_t* f0 = new uint32_t[n * 4 + n / 2];
+	uint32_t* f1 = f0 + n;
+	uint32_t* f2 = f1 + n;
+	uint32_t* scratch = f2 + n;
+	NTTConvolve<P0, 3>(f0, scratch, n, a, na, b, nb);
+	NTTConvolve<P1, 3>(f1, scratch, n, a, na, b, nb);
+	NTTConvolve<P2, 11>(f2, scratch, n, a, na, b, nb);
+	/*Garner's method.  x = r0 + P0*t1 + P0*P1*t2.*/
+	const uint64_t inv0 = PowModP<P1>(P0 % P1, P1 - 2);
+	const uint64_t inv01
+		= PowModP<P2>(uint32_t(uint64_t(P0) * P1 % P2), P2 - 2);
+	const uint64_t P01 = uint64_t(P0) * P1;
+	ZeroOut(r, sr);
+	uint64_t carry = 0;
+	for (std::size_t i = 0; i < pr; ++i)
+	{
+		const uint64_t r0 = f0[i];
+		const uint64_t t1 = (uint64_t(f1[i]) + P1 - r0 % P1) % P1 * inv0 % P1;
+		const uint64_t v = (r0 + P0 * t1) % P2;
+		const uint64_t t2 = (uint64_t(f2[i]) + P2 - v) % P2 * inv01 % P2;
+		carry += r0 + P0 * t1 + P01 * t2;
+		WriteBits(r, sr, i * 16, 16, carry & 0xFFFF);
+		carry >>= 16;
+	}
+	delete[] f0;
+}
+/**Schoolbook squaring.  Each cross product is done once and doubled.
+\param r [out] The square.  Must have room for n + n units and must not
+overlap a.
+\param a The array.
+\param n The size of a.*/
+template<typename T>
+inline void SqrArray_School(T* r, const T* a, const std::size_t n)
+{
+	ZeroOut(r, n + n);
+	if (n == 0)
+		return;
+	for (std::size_t i = 0; i + 1 < n; ++i)
+		r[i + n] = AddMulArray(r + i + i + 1, a + i + 1, n - i - 1, a[i]);
+	ShiftSigB(r, n + n, 1);
+	unsigned char carry = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		T hi;
+		T lo = MulUnit(a[i], a[i], hi);
+		carry = AddCarry(carry, r[i + i], lo, r[i + i]);
+		carry = AddCarry(carry, r[i + i + 1], hi, r[i + i + 1]);
+	}
+}
+/**Karatsuba squaring.  Sub squares are done with SqrArray so that they may
+use any algorithm.
+\param r [out] The square.  Must have room for n + n units and must not
+overlap a.
+\param a The array.
+\param n The size of a.*/
+template<typename T>
+inline void SqrArray_Karatsuba(T* r, const T* a, const std::size_t n)
+{
+	const std::size_t h = (n + 1) / 2;
+	const std::size_t sr = n + n;
+	const std::size_t z1Size = h + h + 2;
+	T* sa = new T[h + 1 + z1Size];
+	T* z1 = sa + h + 1;
+	std::memcpy(sa, a, h * sizeof(T));
+	sa[h] = 0;
+	AddArray(sa, h + 1, a + h, n - h);
+	SqrArray(r, a, h);
+	SqrArray(r + h + h, a + h, n - h);
+	/*z1 = (a0 + a1)^2 - z0 - z2*/
+	SqrArray(z1, sa, h + 1);
+	SubArray(z1, z1Size, r, h + h);
+	SubArray(z1, z1Size, r + h + h, sr - h - h);
+	AddArray(r + h, sr - h, z1, RealSize(z1, z1Size));
+	delete[] sa;
+}
+/**Squaring with a number theoretic transform.  Only one forward transform
+is done per prime.
+\param r [out] The square.  Must have room for n + n units and must not
+overlap a.
+\param a The array.
+\param n The size of a.*/
+template<typename T>
+inline void SqrArray_NTT(T* r, const T* a, const std::size_t n)
+{
+	MulArray_NTT(r, a, n, a, n);
+}
+/**Square an array, choosing the algorithm by its size.  See cg::Thresholds.
+\param r [out] The square.  Must have room for n + n units and must not
+overlap a.
+\param a The array.
+\param n The size of a.*/
+template<typename T>
+inline void SqrArray(T* r, const T* a, const std::size_t n)
+{
+	if (n < Thresholds::Karatsuba)
+		SqrArray_School(r, a, n);
+	else if (n >= Thresholds::NTT)
+		SqrArray_NTT(r, a, n);
+	else if (n < Thresholds::Toom3)
+		SqrArray_Karatsuba(r, a, n);
+	else if (n < Thresholds::Toom4)
+		MulArray_Toom3(r, a, n, a, n);
+	else
+		MulArray_Toom4(r, a, n, a, n);
+}
+/**Multiply two arrays, choosing the algorithm by the size of the operands.
+See cg::Thresholds.
+\param r [out] The product.  Must have room for na + nb units and must not
+overlap a or b.
+\param a The first array.
+\param na The size of a.
+\param b The second array.
+\param nb The size of b.*/
+template<typename T>
+inline void MulArray(T* r, const T* a, const std::size_t na,
+	const T* b, const std::size_t nb)
+{
+	if (na < nb)
+	{
+		MulArray(r, b, nb, a, na);
+		return;
+	}
+	if (nb == 0)
+	{
+		ZeroOut(r, na);
+		return;
+	}
+	if (a == b && na == nb)
+	{
+		SqrArray(r, a, na);
+		return;
+	}
+	if (nb < Thresholds::Karatsuba)
+	{
+		MulArray_School(r, a, na, b, nb);
+		return;
+	}
+	if (nb >= Thresholds::NTT)
+	{
+		MulArray_NTT(r, a, na, b, nb);
+		return;
+	}
+	if (nb + nb <= na)
+	{/*Too lopsided to split evenly.  Do it in nb sized chunks of a.*/
+		const std::size_t sr = na + nb;
+		T* t = new T[nb + nb];
+		ZeroOut(r, sr);
+		for (std::size_t i = 0; i < na; i += nb)
+		{
+			const std::size_t len = (na - i) < nb ? (na - i) : nb;
+			MulArray(t, a + i, len, b, nb);
+			AddArray(r + i, sr - i, t, len + nb);
+		}
+		delete[] t;
+		return;
+	}
+	if (nb < Thresholds::Toom3)
+		MulArray_Karatsuba(r, a, na, b, nb);
+	else if (nb < Thresholds::Toom4)
+		MulArray_Toom3(r, a, na, b, nb);
+	else
+		MulArray_Toom4(r, a, na, b, nb);
+}
+/**Multiply arr1 by arr2 in place with an out-of-place kernel.
+\param arr1 The first array.  Will be the answer, truncated to s1 units.
+\param s1 the max size of arr1.
+\param arr2 The second array.
+\param s2 The max size of r2.
+\param kernel The kernel that computes the product.
+\return True if the product did not fit in s1 units.*/
+template<typename T>
+inline bool MulInPlace(T* arr1, const std::size_t s1, const T* arr2,
+	const std::size_t s2, MulKernelPtr<T> kernel)
+{
+	const std::size_t na = RealSize(arr1, s1);
+	const std::size_t nb = RealSize(arr2, s2);
+	if (na == 0 || nb == 0)
+	{
+		ZeroOut(arr1, s1);
+		return false;
+	}
+	const std::size_t sr = na + nb;
+	const std::size_t keep = sr < s1 ? sr : s1;
+	T* r = new T[sr];
+	if (na >= nb)
+		(kernel)(r, arr1, na, arr2, nb);
+	else
+		(kernel)(r, arr2, nb, arr1, na);
+	std::memcpy(arr1, r, keep * sizeof(T));
+	ZeroOut(arr1 + keep, s1 - keep);
+	bool overflow = !IsZero(r + keep, sr - keep);
+	delete[] r;
+	return overflow;
+}
+/**The mult function.  The algorithm is picked by the size of the operands,
+see cg::Thresholds.
+\param arr1 The first array.  Will be the answer, truncated to s1 units.
+\param s1 the max size of arr1.
+\param arr2 The second array.
+\param s2 The max size of r2.
+\return True if the product did not fit in s1 units.*/
+template<typename T>
+inline bool MulArray(T* arr1, const  std::size_t s1,
+	const T* arr2, const std::size_t s2)
+{
+	return MulInPlace(arr1, s1, arr2, s2, &MulArray<T>);
+}
+/**The mult function.  The algorithm is picked by the size of the operands,
+see cg::Thresholds.
+\param arr1 The first array.
+\param arr2 The second array.
+\return True if the product did not fit in arr1.*/
+template<typename T>
+inline bool MulArray(cg::ArrayView<T>& arr1, const cg::ArrayView<T>& arr2)
+{
+	return MulArray(arr1.Begin(), arr1.Size(), arr2.Begin(), arr2.Size());
+}
+/**The mult function using only the schoolbook method.
+\param arr1 The first array.  Will be the answer, truncated to s1 units.
+\param s1 the max size of arr1.
+\param arr2 The second array.
+\param s2 The max size of r2.
+\return True if the product did not fit in s1 units.*/
+template<typename T>
+inline bool MulArray_School(T* arr1, const  std::size_t s1,
+	const T* arr2, const std::size_t s2)
+{
+	return MulInPlace(arr1, s1, arr2, s2, &MulArray_School<T>);
+}
+/**The mult function with Karatsuba at the top level.
+\param arr1 The first array.  Will be the answer, truncated to s1 units.
+\param s1 the max size of arr1.
+\param arr2 The second array.
+\param s2 The max size of r2.
+\return True if the product did not fit in s1 units.*/
+template<typename T>
+inline bool MulArray_Karatsuba(T* arr1, const  std::size_t s1,
+	const T* arr2, const std::size_t s2)
+{
+	return MulInPlace(arr1, s1, arr2, s2, &MulArray_Karatsuba<T>);
+}
+/**The mult function with Toom-3 at the top level.
+\param arr1 The first array.  Will be the answer, truncated to s1 units.
+\param s1 the max size of arr1.
+\param arr2 The second array.
+\param s2 The max size of r2.
+\return True if the product did not fit in s1 units.*/
+template<typename T>
+inline bool MulArray_Toom3(T* arr1, const  std::size_t s1,
+	const T* arr2, const std::size_t s2)
+{
+	return MulInPlace(arr1, s1, arr2, s2, &MulArray_Toom3<T>);
+}
+/**The mult function with Toom-4 at the top level.
+\param arr1 The first array.  Will be the answer, truncated to s1 units.
+\param s1 the max size of arr1.
+\param arr2 The second array.
+\param s2 The max size of r2.
+\return True if the product did not fit in s1 units.*/
+template<typename T>
+inline bool MulArray_Toom4(T* arr1, const  std::size_t s1,
+	const T* arr2, const std::size_t s2)
+{
+	return MulInPlace(arr1, s1, arr2, s2, &MulArray_Toom4<T>);
+}
+/**The mult function with a number theoretic transform at the top level.
+\param arr1 The first array.  Will be the answer, truncated to s1 units.
+\param s1 the max size of arr1.
+\param arr2 The second array.
+\param s2 The max size of r2.
+\return True if the product did not fit in s1 units.*/
+template<typename T>
+inline bool MulArray_NTT(T* arr1, const  std::size_t s1,
+	const T* arr2, const std::size_t s2)
+{
+	return MulInPlace(arr1, s1, arr2, s2, &MulArray_NTT<T>);
+}
+/**Square an array in place.  The algorithm is picked by the size of the
+array, see cg::Thresholds.
+\param arr The array.  Will be the answer, truncated to s units.
+\param s The size of the array.
+\return True if the square did not fit in s units.*/
+template<typename T>
+inline bool SqrArray(T* arr, const std::size_t s)
+{
+	return MulInPlace(arr, s, arr, s, &MulArray<T>);
+}
+/**Iteger power function.
+\param num A reference to the number to apply to the power.
+\param exp The exponent to apply.
+\return A reference to num*/
+template<typename T>
+inline T& PowInPlace(T& num, std::size_t exp)
+{
+	if (exp == 0)
+	{
+		num = 1;
+		return num;
+	}
+	T base = num;
+	num = 1;
+	while (exp)
+	{
+		if (exp & 1)
+			num *= base;
+		exp >>= 1;
+		/*`base *= base` is seen as a square by types that look for it.*/
+		if (exp)
+			base *= base;
+	}
+	return num;
+
+}
+/**Shift an array to its maximum value while staying less than some other num.
+\param arr1 The array that will be shifted.
+\param s1 The size of arr1.
+\param arr2 The second array that will remain larger than arr1.
+\param s2 The size of the second array.
+\param max The total amount of shifts that may be made.
+\return The amount of shifts made on arr1.*/
+template<typename T>
+inline std::size_t MaximumShift(T* arr1, const std::size_t s1, const T* arr2,
+	const std::size_t s2, const  std::size_t max)
+{
+	if (max == 0)
+		return 0;
+	std::size_t msb_1 = MSBNumber(arr1, s1);
+	std::size_t msb_2 = MSBNumber(arr2, s2);
+	if (msb_1 < msb_2)
+	{
+		std::size_t shiftAmt = (msb_2 - 1) - msb_1;
+		shiftAmt = shiftAmt <= max ? shiftAmt : max;
+		ShiftSigB(arr1, s1, shiftAmt);
+		return shiftAmt;
+	}
+	else if (msb_1 > msb_2)
+	{
+		std::size_t shiftAmt = (msb_1)-(msb_2 - 1);
+		shiftAmt = shiftAmt <= max ? shiftAmt : max;
+		ShiftInsigB(arr1, s1, shiftAmt);
+		return shiftAmt;
+	}
+	/*both are the same msb*/
+	std::size_t shiftAmt = 1;
+	shiftAmt = shiftAmt <= max ? shiftAmt : max;
+	ShiftInsigB(arr1, s1, shiftAmt);
+	return shiftAmt;
+}
+/**Shift an array to its maximum value while staying less than some other num.
+\param arr1 The array that will be shifted.
+\param arr2 The second array that will remain larger than arr1.
+\param max The total amount of shifts that may be made.
+\return The amount of shifts made on arr1.*/
+template<typename T>
+inline std::size_t MaximumShift(cg::ArrayView<T>& arr1,
+	const cg::ArrayView<T>& arr2, const std::size_t max)
+{
+	return MaximumShift(arr1.Begin(), arr1.Size(),
+		arr2.Begin(), arr2.Size(), max);
+}
+/**The basic division function.  This function assumes there are no MSB zeros.
+\param arr1 The first dividend array.  Will be the answer after the function
+returnes.
+\param s1 The size of the first array.
+\param arr2 The second divisor array.
+\param s2 The size of the second array.
+\param arr3 The third array that will hold the modulo of the operation. If its
+nullptr (or 0) it will be ignored.  If its not false, it must be the same size
+as s1.*/
+template<typename T>
+inline void DivArray_Shift(T* arr1, const std::size_t s1, const T* arr2,
+	const std::size_t s2, T* arr3)
+{
+	static_assert(sizeof(T) > 1, "T must be at least 2 bytes long.");
+	const static T TMax = std::numeric_limits<T>::max();
+	const std::size_t s1T = s1 * sizeof(T);
+	if ((s1 == 1) && (s2 == 1))
+	{
+		if (arr3)
+			*arr3 = *arr1;
+		*arr1 /= *arr2;
+		if (arr3)
+			*arr3 %= *arr2;
+		return;
+	}
+	if (IsZero(arr2, s2))
+		throw std::invalid_argument("Divisor is zero.");
+	if (IsOne(arr2, s2))
+	{
+		if (arr3)
+			ZeroOut(arr3, s1);
+		return;
+	}
+	bool cleanArr3 = false;
+	if (!arr3)
+	{
+		arr3 = new T[s1];
+		cleanArr3 = true;
+	}
+	/*move the contents of array-1 into array-3 so that it contains the answer
+	when all is said and done.*/
+	std::memmove(arr3, arr1, s1 * sizeof(T));
+	/**arr1 will be the counter (and then the answer when done).*/
+	std::memset(arr1, 0, s1 * sizeof(T));
+	T* answerCounter = arr1;
+	T* dividend = arr3;
+	T* divisor = new T[s1]();
+	std::memmove(divisor, arr2, s2 * sizeof(T));
+	auto compareResult = CompareArray(dividend, s1, divisor, s1);
+	if (compareResult == 0)
+	{/*Both oprands are the same, answer = 1, modulo = 0 (already moved
+	 to the right spots by this line).*/
+		answerCounter[0] = 1;
+		std::memset(dividend, 0, s1T);
+	}
+	/*arr1 is larger, can do some math here.*/
+	auto shifted = MaximumShift(divisor, s1, dividend, s1, TMax);
+	compareResult = CompareArray(dividend, s1, divisor, s1);
+	while (compareResult == 1)
 	{
 		SubArray(dividend, s1, divisor, s1);
 		AddArray<T>(answerCounter, s1, 1);
@@ -447,30 +1701,229 @@ inline void DivArray_Shift(T* arr1, const std::size_t s1, const T* arr2,
 			}
 		}
 	}
-	if (cleanArr3)
-		delete[] arr3;
-	delete[] divisor;
+	if (cleanArr3)
+		delete[] arr3;
+	delete[] divisor;
+}
+
+/**The basic division function.  This function assumes there are no MSB zeros.
+\param arr1 The first dividend array.
+\param arr2 The second divisor array.
+\param arr3 The third array that will hold the modulo of the operation. Iff its
+nullptr (or 0) it will be ignored.  If its not false, it must be the same size
+as s1.*/
+template<typename T>
+inline void DivArray_Shift(cg::ArrayView<T>& arr1, 
+	const cg::ArrayView<T>& arr2, cg::ArrayView<T>& arr3)
+{
+	if (arr1.Size() != arr3.Size())
+		throw std::runtime_error(
+			"The size of arr1 and arr2 must be the same.");
+	DivArray_Shift(arr1.Begin(), arr1.Size(), arr2.Begin(),
+		arr2.Size(), arr3.Begin());
+}
+
+/**The core of Knuth algorithm D.  Both operands must already be normalized
+so the top unit of the divisor has its high bit set.
+\param q [out] The quotient.  Gets m - n + 1 units.  May be un + n, then the
+quotient replaces the top of the dividend as it is used up.
+\param un The dividend, with m + 1 units.  The top unit must make the top n
+units less than the divisor.  Will hold the remainder in its low n units and
+zeros (or the quotient) above that.
+\param m The size of un, minus the extra top unit.
+\param vn The divisor.  Must have at least 2 units.
+\param n The size of vn.*/
+template<typename T>
+inline void DivArray_KnuthCore(T* q, T* un, const std::size_t m,
+	const T* vn, const std::size_t n)
+{
+	const T top = vn[n - 1];
+	const T next = vn[n - 2];
+	for (std::size_t j = m - n + 1; j-- > 0;)
+	{
+		T* u = un + j;
+		/*Estimate the quotient unit from the top two units of the remainder
+		and the top unit of the divisor.  The remainder is always less than
+		the divisor, so u[n] <= top.*/
+		T qhat;
+		T rhat;
+		unsigned char rOver = 0;
+		if (u[n] == top)
+		{
+			qhat = std::numeric_limits<T>::max();
+			rOver = AddCarry<T>(0, u[n - 1], top, rhat);
+		}
+		else
+			qhat = DivUnit(u[n], u[n - 1], top, rhat);
+		while (!rOver)
+		{
+			T hi;
+			T lo = MulUnit(qhat, next, hi);
+			if (hi < rhat || (hi == rhat && lo <= u[n - 2]))
+				break;
+			--qhat;
+			rOver = AddCarry<T>(0, rhat, top, rhat);
+		}
+		/*u -= qhat * vn*/
+		const T carry = SubMulArray(u, vn, n, qhat);
+		if (SubBorrow<T>(0, u[n], carry, u[n]))
+		{/*The estimate was one too large, add a divisor back.*/
+			--qhat;
+			AddArray(u, n + 1, vn, n);
+		}
+		q[j] = qhat;
+	}
+}
+/**Long division (Knuth, TAOCP vol 2, 4.3.1, algorithm D).  The operands are
+normalized so the top unit of the divisor has its high bit set, then each
+quotient unit is estimated from the top units and corrected at most twice.
+MSB zeros are allowed on both operands.  Nothing is allocated when arr3 is
+given and arr1 has an MSB zero.
+\param arr1 The first dividend array.  Will be the answer after the function
+returnes.
+\param s1 The size of the first array.
+\param arr2 The second divisor array.
+\param s2 The size of the second array.
+\param arr3 The third array that will hold the modulo of the operation. If its
+nullptr (or 0) it will be ignored.  If its not false, it must be the same size
+as s1.*/
+template<typename T>
+inline void DivArray_Knuth(T* arr1, const std::size_t s1, const T* arr2,
+	const std::size_t s2, T* arr3)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	const std::size_t n = RealSize(arr2, s2);
+	if (n == 0)
+		throw std::invalid_argument("Divisor is zero.");
+	const std::size_t m = RealSize(arr1, s1);
+	if (m < n)
+	{
+		if (arr3)
+			std::memmove(arr3, arr1, s1 * sizeof(T));
+		ZeroOut(arr1, s1);
+		return;
+	}
+	if (n == 1)
+	{
+		const T rem = DivArray(arr1, m, arr2[0]);
+		if (arr3)
+		{
+			ZeroOut(arr3, s1);
+			arr3[0] = rem;
+		}
+		return;
+	}
+	const std::size_t sh = TBits - MSBNumber(arr2 + n - 1, 1);
+	const std::size_t sq = m - n + 1;
+	T* temp = nullptr;
+	T* un = arr3;
+	T* vn = arr1;
+	if (!arr3 || m == s1)
+	{
+		temp = new T[m + 1 + n];
+		un = temp;
+		vn = temp + m + 1;
+	}
+	/*Otherwise the dividend is moved to arr3, and the divisor to arr1.*/
+	std::memcpy(un, arr1, m * sizeof(T));
+	un[m] = 0;
+	std::memcpy(vn, arr2, n * sizeof(T));
+	ShiftSigB(un, m + 1, sh);
+	ShiftSigB(vn, n, sh);
+	DivArray_KnuthCore(un + n, un, m, vn, n);
+	std::memcpy(arr1, un + n, sq * sizeof(T));
+	ZeroOut(arr1 + sq, s1 - sq);
+	if (arr3)
+	{
+		ShiftInsigB(un, n, sh);
+		if (un != arr3)
+			std::memcpy(arr3, un, n * sizeof(T));
+		ZeroOut(arr3 + n, s1 - n);
+	}
+	delete[] temp;
 }
 
-/**The basic division function.  This function assumes there are no MSB zeros.
+/**Long division (Knuth algorithm D).
 \param arr1 The first dividend array.
 \param arr2 The second divisor array.
 \param arr3 The third array that will hold the modulo of the operation. Iff its
 nullptr (or 0) it will be ignored.  If its not false, it must be the same size
 as s1.*/
 template<typename T>
-inline void DivArray_Shift(cg::ArrayView<T>& arr1, 
+inline void DivArray_Knuth(cg::ArrayView<T>& arr1,
 	const cg::ArrayView<T>& arr2, cg::ArrayView<T>& arr3)
 {
 	if (arr1.Size() != arr3.Size())
 		throw std::runtime_error(
 			"The size of arr1 and arr2 must be the same.");
-	DivArray_Shift(arr1.Begin(), arr1.Size(), arr2.Begin(),
+	DivArray_Knuth(arr1.Begin(), arr1.Size(), arr2.Begin(),
 		arr2.Size(), arr3.Begin());
 }
 
 
-/**The basic division function.  This function assumes there are no MSB zeros.
+template<typename T>
+inline void DivArray_Split2n1n(T* q, T* a, const T* b, const std::size_t n);
+/**Divide 3h units by 2h units for the recursive division.  The top half of
+the quotient is estimated with a 2h by h division on the top halves, then
+corrected like a unit of Knuth algorithm D.
+\param q [out] The quotient, h units.
+\param a The dividend, 3h units.  Must be less than b shifted up by h
+units.  Will hold the remainder in its low 2h units and zeros above that.
+\param b The divisor, 2h units.  Must be normalized.
+\param h Half the size of the divisor.*/
+template<typename T>
+inline void DivArray_Split3n2n(T* q, T* a, const T* b, const std::size_t h)
+{
+	const T* b1 = b + h;
+	/*The sign and overflow of the remainder while it is corrected.*/
+	int ext = 0;
+	if (CompareArray(a + h + h, h, b1, h) == -1)
+		DivArray_Split2n1n(q, a + h, b1, h);
+	else
+	{/*The top of a equals b1, the estimate is the largest h unit value and
+	 the partial remainder is the middle of a plus b1.*/
+		for (std::size_t i = 0; i < h; ++i)
+			q[i] = std::numeric_limits<T>::max();
+		ext = AddArray(a + h, h, b1, h) ? 1 : 0;
+		ZeroOut(a + h + h, h);
+	}
+	T* d = new T[h + h];
+	MulArray(d, q, h, b, h);
+	if (SubArray(a, h + h, d, h + h))
+		--ext;
+	while (ext < 0)
+	{
+		SubArray(q, h, T(1));
+		if (AddArray(a, h + h, b, h + h))
+			++ext;
+	}
+	delete[] d;
+}
+/**Divide 2n units by n units for the recursive division.  Sizes that can
+not be halved, or that are too small to gain from it, use Knuth algorithm D.
+\param q [out] The quotient, n units.
+\param a The dividend, 2n units.  Must be less than b shifted up by n
+units.  Will hold the remainder in its low n units and zeros above that.
+\param b The divisor, n units.  Must be normalized.
+\param n The size of the divisor.*/
+template<typename T>
+inline void DivArray_Split2n1n(T* q, T* a, const T* b, const std::size_t n)
+{
+	if (n % 2 || n < Thresholds::BurnikelZiegler)
+	{
+		DivArray_KnuthCore(q, a, n + n - 1, b, n);
+		return;
+	}
+	const std::size_t h = n / 2;
+	DivArray_Split3n2n(q + h, a + h, b, h);
+	DivArray_Split3n2n(q, a, b, h);
+}
+/**Recursive division (Burnikel and Ziegler).  The divisor is padded and
+normalized to a size that halves down to the Knuth algorithm D threshold,
+then the dividend is divided one block at a time, each block splitting into
+two half size divisions whose cost is mostly multiplication.  Small
+divisors use Knuth algorithm D directly.  MSB zeros are allowed on both
+operands.
 \param arr1 The first dividend array.  Will be the answer after the function
 returnes.
 \param s1 The size of the first array.
@@ -483,17 +1936,67 @@ template<typename T>
 inline void DivArray_Split(T* arr1, const std::size_t s1, const T* arr2,
 	const std::size_t s2, T* arr3)
 {
-	std::size_t position = 0;
-	T* answer = new T[s1]();
-	T* mod = new T[s2]();
-	for (std::size_t i = 0; i < s2; ++i)
+	const std::size_t TBits = sizeof(T) * 8;
+	const std::size_t n = RealSize(arr2, s2);
+	const std::size_t m = RealSize(arr1, s1);
+	if (n < Thresholds::BurnikelZiegler
+		|| m < n + Thresholds::BurnikelZiegler)
 	{
-		
-
+		DivArray_Knuth(arr1, s1, arr2, s2, arr3);
+		return;
+	}
+	/*Pad the divisor to j * 2^k units with j under the threshold.*/
+	std::size_t j = n;
+	std::size_t k = 0;
+	while (j >= Thresholds::BurnikelZiegler)
+	{
+		j = (j + 1) / 2;
+		++k;
+	}
+	const std::size_t bn = j << k;
+	const std::size_t shift = (bn - n) * TBits
+		+ (TBits - MSBNumber(arr2 + n - 1, 1));
+	/*The shifted dividend, a zero unit above it and room for the top
+	block.*/
+	const std::size_t su = m + bn - n + 2 + bn;
+	T* u = new T[su + bn + su];
+	T* b = u + su;
+	T* q = b + bn;
+	ZeroOut(u, su);
+	ZeroOut(q, su);
+	std::memcpy(u, arr1, m * sizeof(T));
+	ShiftSigB(u, su, shift);
+	ZeroOut(b, bn);
+	std::memcpy(b, arr2, n * sizeof(T));
+	ShiftSigB(b, bn, shift);
+	const std::size_t mu = RealSize(u, su);
+	const std::size_t qn = mu - bn + 1;
+	/*The top quotient units that do not fill a block are found with Knuth
+	algorithm D when there are few of them, otherwise they are a block whose
+	top is mostly zero.  The rest are found one block at a time.*/
+	std::size_t pos = qn - qn % bn;
+	if (qn % bn >= Thresholds::BurnikelZiegler)
+		pos += bn;
+	else if (pos != qn)
+		DivArray_KnuthCore(q + pos, u + pos, mu - pos, b, bn);
+	while (pos)
+	{
+		pos -= bn;
+		DivArray_Split2n1n(q + pos, u + pos, b, bn);
+	}
+	const std::size_t sq = qn < s1 ? qn : s1;
+	ZeroOut(arr1, s1);
+	std::memcpy(arr1, q, sq * sizeof(T));
+	if (arr3)
+	{
+		ZeroOut(arr3, s1);
+		ShiftInsigB(u, bn, shift);
+		std::memcpy(arr3, u, n * sizeof(T));
 	}
+	delete[] u;
 }
 
-/**The basic division function.  This function assumes there are no MSB zeros.
+/**Recursive division (Burnikel and Ziegler).
 \param arr1 The first dividend array.
 \param arr2 The second divisor array.
 \param arr3 The third array that will hold the modulo of the operation. Iff its
@@ -510,4 +2013,1083 @@ inline void DivArray_Split(cg::ArrayView<T>& arr1,
 		arr2.Size(), arr3.Begin());
 }
 
+/**Find an approximate reciprocal of a normalized array with Newton's method
+(Brent and Zimmermann, Modern Computer Arithmetic, algorithm 3.5).  The
+reciprocal of the top half is found first (recursively), then one Newton
+step doubles its precision.  Small arrays are divided directly.
+\param r [out] The reciprocal, x with a * x < B^(2n) <= a * (x + 2) where B
+is the unit base.  Must have room for n + 1 units.
+\param a The array.  The high bit of its top unit must be set.
+\param n The size of a.*/
+template<typename T>
+inline void InvertArrayApprox(T* r, const T* a, const std::size_t n)
+{
+	if (n < Thresholds::BurnikelZiegler || n < 3)
+	{
+		const std::size_t sn = n + n + 1;
+		T* p = new T[sn + sn];
+		T* mod = p + sn;
+		ZeroOut(p, sn);
+		p[n + n] = 1;
+		DivArray_Split(p, sn, a, n, mod);
+		if (IsZero(mod, sn))
+			SubArray(p, sn, T(1));
+		std::memcpy(r, p, (n + 1) * sizeof(T));
+		delete[] p;
+		return;
+	}
+	const std::size_t l = (n - 1) / 2;
+	const std::size_t h = n - l;
+	const std::size_t st = n + h + 1;
+	T* t = new T[st + st + 3 * h + 2];
+	T* e = t + st;
+	T* u = e + st;
+	/*xh = the reciprocal of the top h units of a, kept in the top of r.*/
+	T* xh = r + l;
+	InvertArrayApprox(xh, a + l, h);
+	MulArray(t, a, n, xh, h + 1);
+	while (t[n + h])
+	{
+		SubArray(xh, h + 1, T(1));
+		SubArray(t, st, a, n);
+	}
+	/*e = B^(n+h) - a * xh*/
+	ZeroOut(e, st);
+	e[n + h] = 1;
+	SubArray(e, st, t, st);
+	/*r = xh * B^l + (top of e) * xh / B^(2h-l)*/
+	MulArray(u, e + l, h + h + 1, xh, h + 1);
+	ZeroOut(r, l);
+	AddArray(r, n + 1, u + h + h - l, 3 * h + 2 - (h + h - l));
+	delete[] t;
+}
+/**Find the reciprocal of a normalized array.  Newton's method (see
+InvertArrayApprox) gets to within 2 of it and one multiplication corrects
+it, so the cost is a small multiple of one multiplication.
+\param r [out] The reciprocal, floor(B^(2n) / a) where B is the unit base.
+Must have room for n + 1 units.
+\param a The array.  The high bit of its top unit must be set.
+\param n The size of a.*/
+template<typename T>
+inline void InvertArray(T* r, const T* a, const std::size_t n)
+{
+	if (n == 0 || !(a[n - 1] >> (sizeof(T) * 8 - 1)))
+		throw std::invalid_argument("The array must be normalized.");
+	InvertArrayApprox(r, a, n);
+	const std::size_t sn = n + n + 1;
+	T* p = new T[sn + sn];
+	T* e = p + sn;
+	MulArray(p, r, n + 1, a, n);
+	/*e = B^(2n) - a * r, which is positive and less than 3a.*/
+	ZeroOut(e, sn);
+	e[n + n] = 1;
+	SubArray(e, sn, p, sn);
+	while (CompareArray(e, RealSize(e, sn), a, n) != -1)
+	{
+		AddArray(r, n + 1, T(1));
+		SubArray(e, sn, a, n);
+	}
+	delete[] p;
+}
+/**Division by multiplying with the reciprocal of the divisor (see
+InvertArray).  Each block of quotient units is estimated from one product
+with the reciprocal and corrected by a few subtractions, so a division costs
+a small multiple of a multiplication.  Small divisors or quotients use
+DivArray_Split.  MSB zeros are allowed on both operands.
+\param arr1 The first dividend array.  Will be the answer after the function
+returnes.
+\param s1 The size of the first array.
+\param arr2 The second divisor array.
+\param s2 The size of the second array.
+\param arr3 The third array that will hold the modulo of the operation. If its
+nullptr (or 0) it will be ignored.  If its not false, it must be the same size
+as s1.*/
+template<typename T>
+inline void DivArray_Newton(T* arr1, const std::size_t s1, const T* arr2,
+	const std::size_t s2, T* arr3)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	const std::size_t n = RealSize(arr2, s2);
+	const std::size_t m = RealSize(arr1, s1);
+	if (n < Thresholds::Newton || m < n + Thresholds::Newton)
+	{
+		DivArray_Split(arr1, s1, arr2, s2, arr3);
+		return;
+	}
+	const std::size_t sh = TBits - MSBNumber(arr2 + n - 1, 1);
+	/*The shifted dividend, a zero unit above it and room for the top
+	block.*/
+	const std::size_t su = m + n + 2;
+	T* u = new T[su + su + n + n + 1 + n + n + 1];
+	T* q = u + su;
+	T* b = q + su;
+	T* v = b + n;
+	T* t = v + n + 1;
+	ZeroOut(u, su);
+	ZeroOut(q, su);
+	std::memcpy(u, arr1, m * sizeof(T));
+	ShiftSigB(u, su, sh);
+	std::memcpy(b, arr2, n * sizeof(T));
+	ShiftSigB(b, n, sh);
+	InvertArray(v, b, n);
+	const std::size_t mu = RealSize(u, su);
+	const std::size_t qn = mu - n + 1;
+	std::size_t pos = (qn + n - 1) / n * n;
+	while (pos)
+	{
+		pos -= n;
+		T* w = u + pos;
+		/*The top half of the window is less than b, so the estimate is less
+		than B^n and at most a few less than the real quotient.*/
+		ZeroOut(t, n + n + 1);
+		MulArray(t, v, n + 1, w + n, RealSize(w + n, n));
+		std::memcpy(q + pos, t + n, n * sizeof(T));
+		MulArray(t, q + pos, n, b, n);
+		SubArray(w, n + n, t, n + n);
+		while (CompareArray(w, RealSize(w, n + n), b, n) != -1)
+		{
+			SubArray(w, n + n, b, n);
+			AddArray(q + pos, n, T(1));
+		}
+	}
+	const std::size_t sq = qn < s1 ? qn : s1;
+	ZeroOut(arr1, s1);
+	std::memcpy(arr1, q, sq * sizeof(T));
+	if (arr3)
+	{
+		ZeroOut(arr3, s1);
+		ShiftInsigB(u, n, sh);
+		std::memcpy(arr3, u, n * sizeof(T));
+	}
+	delete[] u;
+}
+
+/**Division by multiplying with the reciprocal of the divisor.
+\param arr1 The first dividend array.
+\param arr2 The second divisor array.
+\param arr3 The third array that will hold the modulo of the operation. Iff its
+nullptr (or 0) it will be ignored.  If its not false, it must be the same size
+as s1.*/
+template<typename T>
+inline void DivArray_Newton(cg::ArrayView<T>& arr1,
+	const cg::ArrayView<T>& arr2, cg::ArrayView<T>& arr3)
+{
+	if (arr1.Size() != arr3.Size())
+		throw std::runtime_error(
+			"The size of arr1 and arr2 must be the same.");
+	DivArray_Newton(arr1.Begin(), arr1.Size(), arr2.Begin(),
+		arr2.Size(), arr3.Begin());
+}
+
+/**Find the quotient and the remainder of a division in one pass (Knuth
+algorithm D).  All the work is done in q and r so nothing is allocated.
+\param a The dividend.  May be the same array as q.
+\param na The size of a.
+\param b The divisor.
+\param nb The size of b.
+\param q [out] The quotient.  Must have room for na + 1 units.
+\param r [out] The remainder.  Must have room for na + 1 units.*/
+template<typename T>
+inline void DivMod(const T* a, const std::size_t na, const T* b,
+	const std::size_t nb, T* q, T* r)
+{
+	std::memmove(q, a, na * sizeof(T));
+	q[na] = 0;
+	DivArray_Knuth(q, na + 1, b, nb, r);
+}
+
+/**Count the trailing zero bits of an array.
+\param arr The array.  Must not be zero.
+\param s The size of arr.
+\return The amount of zero bits below the least significant 1 bit.*/
+template<typename T>
+inline std::size_t TrailingZeros(const T* arr, const std::size_t s)
+{
+	const std::size_t units = CountZeros(arr, arr + s);
+	std::size_t bits = 0;
+	for (T t = arr[units]; !(t & 1); t >>= 1)
+		++bits;
+	return units * sizeof(T) * 8 + bits;
+}
+/**Find the greatest common divisor of two units.
+\param a The first unit.
+\param b The second unit.
+\return The GCD, or a when b is zero.*/
+template<typename T>
+inline T GCDUnit(T a, T b)
+{
+	while (b)
+	{
+		const T t = T(a % b);
+		a = b;
+		b = t;
+	}
+	return a;
+}
+/**Binary GCD.  Only subtractions and shifts are used, so it is the fastest
+for small arrays.
+\param a The first array.  Will be the GCD.  Must have room for b if it
+may be zero.
+\param na The size of a.
+\param b The second array.  Will be overwritten.
+\param nb The size of b.
+\return The real size of the GCD.*/
+template<typename T>
+inline std::size_t GCDArray_Binary(T* a, std::size_t na, T* b, std::size_t nb)
+{
+	T* const out = a;
+	const std::size_t nout = na;
+	na = RealSize(a, na);
+	nb = RealSize(b, nb);
+	if (nb == 0)
+		return na;
+	if (na == 0)
+	{
+		std::memcpy(out, b, nb * sizeof(T));
+		return nb;
+	}
+	/*gcd(a, b) = 2^k gcd(a / 2^i, b / 2^j) with k = min(i, j)*/
+	const std::size_t za = TrailingZeros(a, na);
+	const std::size_t zb = TrailingZeros(b, nb);
+	const std::size_t k = za < zb ? za : zb;
+	ShiftInsigB(a, na, za);
+	ShiftInsigB(b, nb, zb);
+	na = RealSize(a, na);
+	nb = RealSize(b, nb);
+	/*Both odd, so the difference is even.*/
+	for (;;)
+	{
+		const int cmp = CompareArray(a, na, b, nb);
+		if (cmp == 0)
+			break;
+		if (cmp == -1)
+		{
+			std::swap(a, b);
+			std::swap(na, nb);
+		}
+		SubArray(a, na, b, nb);
+		na = RealSize(a, na);
+		ShiftInsigB(a, na, TrailingZeros(a, na));
+		na = RealSize(a, na);
+	}
+	if (a != out)
+		std::memcpy(out, a, na * sizeof(T));
+	ZeroOut(out + na, nout - na);
+	ShiftSigB(out, nout, k);
+	return RealSize(out, nout);
+}
+/**A matrix of cofactors for the GCD.  When a and b have been reduced to
+alpha and beta, (a, b) = M (alpha, beta).  The entries are never negative
+and the determinant is 1 or -1 (see Negative).*/
+template<typename T>
+class GCDMatrix
+{
+public:
+	/**A self reference type.*/
+	using Self = GCDMatrix<T>;
+	/**Create an identity matrix.
+	\param cap The most units an entry may take.*/
+	GCDMatrix(const std::size_t cap)
+		:m_cap(cap)
+	{
+		m_data = new T[4 * cap + 3 * (cap + cap + 1)];
+		for (std::size_t i = 0; i < 4; ++i)
+			m_e[i] = m_data + i * cap;
+		m_t1 = m_data + 4 * cap;
+		m_t2 = m_t1 + cap + cap + 1;
+		m_p = m_t2 + cap + cap + 1;
+		Identity();
+	}
+	/**Matrices own their buffers and are not copied.*/
+	GCDMatrix(const Self&) = delete;
+	/**Matrices own their buffers and are not copied.*/
+	void operator=(const Self&) = delete;
+	/**Free the buffers.*/
+	~GCDMatrix()
+	{
+		delete[] m_data;
+	}
+	/**Set to the identity.*/
+	void Identity()
+	{
+		ZeroOut(m_data, 4 * m_cap);
+		m_e[0][0] = 1;
+		m_e[3][0] = 1;
+		m_n[0] = m_n[3] = 1;
+		m_n[1] = m_n[2] = 0;
+		m_neg = false;
+	}
+	/**Check for the identity.
+	\return True if nothing has been done to the matrix.*/
+	bool IsIdentity() const
+	{
+		return !m_neg && m_n[1] == 0 && m_n[2] == 0 && m_n[0] == 1
+			&& m_n[3] == 1 && m_e[0][0] == 1 && m_e[3][0] == 1;
+	}
+	/**Get an entry.
+	\param i The entry, 0 to 3 in row major order.
+	\return The entry.*/
+	const T* Entry(const std::size_t i) const
+	{
+		return m_e[i];
+	}
+	/**Get the size of an entry.
+	\param i The entry, 0 to 3 in row major order.
+	\return The real size of the entry.*/
+	std::size_t EntrySize(const std::size_t i) const
+	{
+		return m_n[i];
+	}
+	/**Get the sign of the determinant.
+	\return True if the determinant is -1.*/
+	bool Negative() const
+	{
+		return m_neg;
+	}
+	/**Record that a and b swapped, M = M (0 1, 1 0).*/
+	void Swap()
+	{
+		std::swap(m_e[0], m_e[1]);
+		std::swap(m_n[0], m_n[1]);
+		std::swap(m_e[2], m_e[3]);
+		std::swap(m_n[2], m_n[3]);
+		m_neg = !m_neg;
+	}
+	/**Record a Euclid step, M = M (q 1, 1 0).
+	\param q The quotient.
+	\param nq The size of q.*/
+	void MulQ(const T* q, const std::size_t nq)
+	{
+		const T one = 1;
+		const T zero = 0;
+		MulRows(q, nq, &one, 1, &one, 1, &zero, 0);
+		m_neg = !m_neg;
+	}
+	/**Record the steps of Lehmer's algorithm that made a = A a + B b and
+	b = C a + D b, M = M (A B, C D)^-1.
+	\param A The cofactor of a for the new a.
+	\param B The cofactor of b for the new a.
+	\param C The cofactor of a for the new b.
+	\param D The cofactor of b for the new b.
+	\param odd True if an odd amount of steps were taken.*/
+	void MulLehmer(const int64_t A, const int64_t B, const int64_t C,
+		const int64_t D, const bool odd)
+	{
+		/*The inverse is (D -B, -C A) times the determinant, which leaves
+		every entry positive.*/
+		const T a = T(A < 0 ? -A : A), b = T(B < 0 ? -B : B);
+		const T c = T(C < 0 ? -C : C), d = T(D < 0 ? -D : D);
+		MulRows(&d, d != 0, &b, b != 0, &c, c != 0, &a, a != 0);
+		m_neg = m_neg != odd;
+	}
+	/**Multiply by another matrix, M = M R.
+	\param r The other matrix.*/
+	void Mul(const Self& r)
+	{
+		MulRows(r.m_e[0], r.m_n[0], r.m_e[1], r.m_n[1],
+			r.m_e[2], r.m_n[2], r.m_e[3], r.m_n[3]);
+		m_neg = m_neg != r.m_neg;
+	}
+	/**Reduce two numbers with the inverse of this matrix,
+	(a, b) = M^-1 (a, b).  Nothing is changed if the result would be negative
+	or bigger than the numbers, as happens when the matrix was found from
+	the leading units alone and went too far.
+	\param a The first number.
+	\param na [in, out] The real size of a.
+	\param b The second number.
+	\param nb [in, out] The real size of b.
+	\param t Work space, 4 (max(na, nb) + Cap() + 1) units.
+	\return True if the numbers were reduced.*/
+	bool ApplyInverse(T* a, std::size_t& na, T* b, std::size_t& nb, T* t)
+		const
+	{
+		const std::size_t l = (na > nb ? na : nb) + m_cap + 1;
+		T* p1 = t;
+		T* p2 = p1 + l;
+		T* p3 = p2 + l;
+		T* p4 = p3 + l;
+		ZeroOut(t, 4 * l);
+		/*alpha = det (m11 a - m01 b), beta = det (m00 b - m10 a)*/
+		if (m_n[3] && na)
+			MulArray(p1, m_e[3], m_n[3], a, na);
+		if (m_n[1] && nb)
+			MulArray(p2, m_e[1], m_n[1], b, nb);
+		if (m_n[0] && nb)
+			MulArray(p3, m_e[0], m_n[0], b, nb);
+		if (m_n[2] && na)
+			MulArray(p4, m_e[2], m_n[2], a, na);
+		if (m_neg)
+		{
+			std::swap(p1, p2);
+			std::swap(p3, p4);
+		}
+		if (SubArray(p1, l, p2, l) || SubArray(p3, l, p4, l))
+			return false;
+		const std::size_t n1 = RealSize(p1, l);
+		const std::size_t n3 = RealSize(p3, l);
+		if (n1 > na || n3 > nb)
+			return false;
+		ZeroOut(a, na);
+		ZeroOut(b, nb);
+		std::memcpy(a, p1, n1 * sizeof(T));
+		std::memcpy(b, p3, n3 * sizeof(T));
+		na = n1;
+		nb = n3;
+		return true;
+	}
+	/**Get the room in each entry.
+	\return The most units an entry may take.*/
+	std::size_t Cap() const
+	{
+		return m_cap;
+	}
+private:
+	/**r = x u + y v for arrays of the given real sizes.
+	\return The real size of r.*/
+	std::size_t MulAdd(T* r, const T* x, const std::size_t sx, const T* u,
+		const std::size_t su, const T* y, const std::size_t sy, const T* v,
+		const std::size_t sv)
+	{
+		const std::size_t s1 = sx && su ? sx + su : 0;
+		const std::size_t s2 = sy && sv ? sy + sv : 0;
+		const std::size_t n = (s1 > s2 ? s1 : s2) + 1;
+		ZeroOut(r, n);
+		if (s1)
+			MulArray(r, x, sx, u, su);
+		if (s2)
+		{
+			MulArray(m_p, y, sy, v, sv);
+			AddArray(r, n, m_p, s2);
+		}
+		const std::size_t s = RealSize(r, n);
+		if (s > m_cap)
+			throw std::runtime_error("GCD matrix entry is too big.");
+		return s;
+	}
+	/**M = M (u00 u01, u10 u11) for arrays of the given real sizes.*/
+	void MulRows(const T* u00, const std::size_t s00, const T* u01,
+		const std::size_t s01, const T* u10, const std::size_t s10,
+		const T* u11, const std::size_t s11)
+	{
+		for (std::size_t i = 0; i < 4; i += 2)
+		{
+			const std::size_t n1 = MulAdd(m_t1, m_e[i], m_n[i], u00, s00,
+				m_e[i + 1], m_n[i + 1], u10, s10);
+			const std::size_t n2 = MulAdd(m_t2, m_e[i], m_n[i], u01, s01,
+				m_e[i + 1], m_n[i + 1], u11, s11);
+			ZeroOut(m_e[i], m_cap);
+			ZeroOut(m_e[i + 1], m_cap);
+			std::memcpy(m_e[i], m_t1, n1 * sizeof(T));
+			std::memcpy(m_e[i + 1], m_t2, n2 * sizeof(T));
+			m_n[i] = n1;
+			m_n[i + 1] = n2;
+		}
+	}
+	/**The most units an entry may take.*/
+	std::size_t m_cap;
+	/**The entries followed by the work space.*/
+	T* m_data;
+	/**The entries in row major order.*/
+	T* m_e[4];
+	/**The real sizes of the entries.*/
+	std::size_t m_n[4];
+	/**True if the determinant is -1.*/
+	bool m_neg;
+	/**Work space for a new row, 2 cap + 1 units each.*/
+	T* m_t1;
+	/**Work space for a new row, 2 cap + 1 units each.*/
+	T* m_t2;
+	/**Work space for a product, 2 cap + 1 units.*/
+	T* m_p;
+};
+/**Do one step of Lehmer's GCD.  The quotients of the Euclidean algorithm are
+found from the leading bits of the arrays, and applied to the whole arrays
+at once with single unit cofactors (Knuth algorithm L).  If no quotient can
+be found that way one full division is done instead.
+\param a [in, out] The first array.  May be swapped with b.
+\param na [in, out] The real size of a.
+\param b [in, out] The second array, not zero.  May be swapped with a.
+\param nb [in, out] The real size of b.
+\param t Work space, 4 (max(na, nb) + 1) units.
+\param m The matrix to record the step in, or nullptr.*/
+template<typename T>
+inline void LehmerStep(T*& a, std::size_t& na, T*& b, std::size_t& nb, T* t,
+	GCDMatrix<T>* m)
+{
+	if (CompareArray(a, na, b, nb) == -1)
+	{
+		std::swap(a, b);
+		std::swap(na, nb);
+		if (m)
+			m->Swap();
+	}
+	/*The leading bits leave room for the cofactors to be added to them.*/
+	const std::size_t p = sizeof(T) * 8 - 2;
+	const std::size_t bits = MSBNumber(a, na);
+	const std::size_t pos = bits > p ? bits - p : 0;
+	int64_t ah = int64_t(ReadBits(a, na, pos, p));
+	int64_t bh = int64_t(ReadBits(b, nb, pos, p));
+	int64_t A = 1, B = 0, C = 0, D = 1;
+	bool odd = false;
+	while (bh + C > 0 && bh + D > 0)
+	{
+		const int64_t q = (ah + A) / (bh + C);
+		if (q != (ah + B) / (bh + D))
+			break;
+		int64_t x = A - q * C;
+		A = C;
+		C = x;
+		x = B - q * D;
+		B = D;
+		D = x;
+		x = ah - q * bh;
+		ah = bh;
+		bh = x;
+		odd = !odd;
+	}
+	if (B == 0)
+	{
+		/*No quotient was certain, so do one step in full.*/
+		DivArray_Knuth(a, na, b, nb, t);
+		if (m)
+			m->MulQ(a, RealSize(a, na - nb + 1));
+		std::memcpy(a, t, nb * sizeof(T));
+		ZeroOut(a + nb, na - nb);
+		std::swap(a, b);
+		na = nb;
+		nb = RealSize(b, nb);
+		return;
+	}
+	T* ta = t + na + 1;
+	T* tb = ta + na + 1;
+	T* tc = tb + na + 1;
+	/*x * a + y * b, where x <= 0 <= y or y <= 0 <= x.*/
+	auto combine = [&](T* r, int64_t x, int64_t y)
+	{
+		const bool neg = y > 0;
+		std::memcpy(ta, a, na * sizeof(T));
+		ta[na] = MulArray(ta, na, T(neg ? -x : x));
+		std::memcpy(tb, b, nb * sizeof(T));
+		ZeroOut(tb + nb, na + 1 - nb);
+		tb[nb] = MulArray(tb, nb, T(neg ? y : -y));
+		if (neg)
+			std::swap(ta, tb);
+		SubArray(ta, na + 1, tb, na + 1);
+		std::memcpy(r, ta, (na + 1) * sizeof(T));
+		if (neg)
+			std::swap(ta, tb);
+	};
+	/*One of A and B is negative, as is one of C and D.*/
+	combine(t, A, B);
+	combine(tc, C, D);
+	std::memcpy(a, t, na * sizeof(T));
+	std::memcpy(b, tc, nb * sizeof(T));
+	na = RealSize(a, na);
+	nb = RealSize(b, nb);
+	if (m)
+		m->MulLehmer(A, B, C, D, odd);
+}
+/**Reduce two numbers to about half their size with the half-GCD.  The
+matrix of the top half of the numbers is found recursively and applied to
+the whole numbers, twice, so the cost follows that of multiplication.
+Lehmer steps are done below Thresholds::HalfGCD units, and whenever a matrix
+from the top half does not fit the whole numbers.
+\param a [in, out] The first array.  May be swapped with b.
+\param na [in, out] The real size of a.
+\param b [in, out] The second array.  May be swapped with a.
+\param nb [in, out] The real size of b.
+\param m The matrix to record the steps in, or nullptr.*/
+template<typename T>
+inline void HalfGCD(T*& a, std::size_t& na, T*& b, std::size_t& nb,
+	GCDMatrix<T>* m)
+{
+	const std::size_t n = na > nb ? na : nb;
+	const std::size_t s = n / 2 + 1;
+	T* t = new T[4 * (n + 1)];
+	/*Reduce the units from p up, then the whole numbers with that matrix.*/
+	auto top = [&](const std::size_t p)
+	{
+		std::size_t n1 = na > p ? na - p : 0;
+		std::size_t n2 = nb > p ? nb - p : 0;
+		const std::size_t n3 = n1 > n2 ? n1 : n2;
+		T* a1 = new T[n3 + n3];
+		T* b1 = a1 + n3;
+		ZeroOut(a1, n3 + n3);
+		std::memcpy(a1, a + p, n1 * sizeof(T));
+		std::memcpy(b1, b + p, n2 * sizeof(T));
+		T* pa = a1;
+		T* pb = b1;
+		GCDMatrix<T> m1(n3 + 1);
+		if (n1 && n2)
+			HalfGCD(pa, n1, pb, n2, &m1);
+		bool done = false;
+		if (!m1.IsIdentity())
+		{
+			T* w = new T[4 * (n + m1.Cap() + 1)];
+			done = m1.ApplyInverse(a, na, b, nb, w);
+			delete[] w;
+			if (done && m)
+				m->Mul(m1);
+		}
+		delete[] a1;
+		if (!done)
+			LehmerStep(a, na, b, nb, t, m);
+	};
+	if (n >= Thresholds::HalfGCD && (na < nb ? na : nb) > s)
+		top(n / 2);
+	/*Aim the second half at s: the top n' units are reduced to n' / 2 + 1.*/
+	std::size_t l = na > nb ? na : nb;
+	if ((na < nb ? na : nb) > s && l + 2 < s + s
+		&& l - (s + s - l - 2) >= Thresholds::HalfGCD)
+		top(s + s - l - 2);
+	while ((na < nb ? na : nb) > s)
+		LehmerStep(a, na, b, nb, t, m);
+	delete[] t;
+}
+/**Lehmer's GCD, see LehmerStep.
+\param a The first array.  Will be the GCD.  Must have room for b if it
+may be zero.
+\param na The size of a.
+\param b The second array.  Will be overwritten.
+\param nb The size of b.
+\return The real size of the GCD.*/
+template<typename T>
+inline std::size_t GCDArray_Lehmer(T* a, std::size_t na, T* b, std::size_t nb)
+{
+	T* const out = a;
+	const std::size_t nout = na;
+	na = RealSize(a, na);
+	nb = RealSize(b, nb);
+	T* t = new T[4 * ((na > nb ? na : nb) + 1)];
+	while (nb > 1)
+		LehmerStep(a, na, b, nb, t, (GCDMatrix<T>*)nullptr);
+	if (nb == 1)
+	{
+		const T r = DivArray(a, na, b[0]);
+		ZeroOut(a, na);
+		a[0] = GCDUnit(b[0], r);
+		na = 1;
+	}
+	if (a != out)
+		std::memcpy(out, a, na * sizeof(T));
+	ZeroOut(out + na, nout - na);
+	delete[] t;
+	return na;
+}
+/**GCD with the half-GCD, see HalfGCD.  Lehmer steps finish it once the
+numbers are below Thresholds::HalfGCD units.
+\param a The first array.  Will be the GCD.  Must have room for b if it
+may be zero.
+\param na The size of a.
+\param b The second array.  Will be overwritten.
+\param nb The size of b.
+\return The real size of the GCD.*/
+template<typename T>
+inline std::size_t GCDArray_HalfGCD(T* a, std::size_t na, T* b,
+	std::size_t nb)
+{
+	T* const out = a;
+	const std::size_t nout = na;
+	na = RealSize(a, na);
+	nb = RealSize(b, nb);
+	T* t = new T[4 * ((na > nb ? na : nb) + 1)];
+	/*The half-GCD only reduces numbers of about the same size.*/
+	while ((na < nb ? na : nb) >= Thresholds::HalfGCD)
+	{
+		if ((na < nb ? na : nb) > (na > nb ? na : nb) / 2 + 1)
+			HalfGCD(a, na, b, nb, (GCDMatrix<T>*)nullptr);
+		else
+			LehmerStep(a, na, b, nb, t, (GCDMatrix<T>*)nullptr);
+	}
+	delete[] t;
+	const std::size_t ng = GCDArray_Lehmer(a, na, b, nb);
+	if (a != out)
+	{
+		std::memcpy(out, a, ng * sizeof(T));
+		ZeroOut(out + ng, nout - ng);
+	}
+	return ng;
+}
+/**Find the greatest common divisor of two arrays.  See Thresholds::Lehmer
+and Thresholds::HalfGCD.
+\param a The first array.  Will be the GCD.  Must have room for b if it
+may be zero.
+\param na The size of a.
+\param b The second array.  Will be overwritten.
+\param nb The size of b.
+\return The real size of the GCD.*/
+template<typename T>
+inline std::size_t GCDArray(T* a, std::size_t na, T* b, std::size_t nb)
+{
+	const std::size_t ra = RealSize(a, na);
+	const std::size_t rb = RealSize(b, nb);
+	const std::size_t n = ra < rb ? ra : rb;
+	if (n < Thresholds::Lehmer)
+		return GCDArray_Binary(a, na, b, nb);
+	if (n < Thresholds::HalfGCD)
+		return GCDArray_Lehmer(a, na, b, nb);
+	return GCDArray_HalfGCD(a, na, b, nb);
+}
+/**Find the GCD and the cofactors of two arrays, so that a x - b y = g with
+1 <= x <= b / g and 0 <= y < a / g.  The cofactors are collected with
+Lehmer steps, or with the half-GCD above Thresholds::HalfGCD units.
+\param a The first array.  Must not be zero.
+\param na The size of a.
+\param b The second array.
+\param nb The size of b.
+\param g [out] The GCD.  Must have room for max(na, nb) units.
+\param x [out] The cofactor of a.  Must have room for max(na, nb) units.
+\param y [out] The cofactor of b, or nullptr.  Must have room for
+max(na, nb) units.
+\return The real size of the GCD.*/
+template<typename T>
+inline std::size_t ExtGCDArray(const T* a, std::size_t na, const T* b,
+	std::size_t nb, T* g, T* x, T* y)
+{
+	na = RealSize(a, na);
+	nb = RealSize(b, nb);
+	if (na == 0)
+		throw std::invalid_argument("The first number is zero.");
+	const std::size_t n = na > nb ? na : nb;
+	T* u = new T[(n + 1) * 6];
+	T* v = u + n + 1;
+	T* t = v + n + 1;
+	ZeroOut(u, n + n + 2);
+	std::memcpy(u, a, na * sizeof(T));
+	std::memcpy(v, b, nb * sizeof(T));
+	GCDMatrix<T> m(n + 1);
+	T* pu = u;
+	T* pv = v;
+	std::size_t nu = na;
+	std::size_t nv = nb;
+	while (nv && nu)
+	{
+		const std::size_t l = nu > nv ? nu : nv;
+		const std::size_t s = nu < nv ? nu : nv;
+		if (s >= Thresholds::HalfGCD && s > l / 2 + 1)
+			HalfGCD(pu, nu, pv, nv, &m);
+		else
+			LehmerStep(pu, nu, pv, nv, t, &m);
+	}
+	if (nu == 0)
+	{
+		std::swap(pu, pv);
+		std::swap(nu, nv);
+		m.Swap();
+	}
+	ZeroOut(g, n);
+	std::memcpy(g, pu, nu * sizeof(T));
+	/*(a, b) = M (g, 0), so g = det (m11 a - m01 b), with m00 = a / g and
+	m10 = b / g.*/
+	ZeroOut(x, n);
+	if (y)
+		ZeroOut(y, n);
+	if (!m.Negative())
+	{
+		std::memcpy(x, m.Entry(3), m.EntrySize(3) * sizeof(T));
+		if (y)
+			std::memcpy(y, m.Entry(1), m.EntrySize(1) * sizeof(T));
+	}
+	else
+	{
+		std::memcpy(x, m.Entry(2), m.EntrySize(2) * sizeof(T));
+		SubArray(x, n, m.Entry(3), m.EntrySize(3));
+		if (y)
+		{
+			std::memcpy(y, m.Entry(0), m.EntrySize(0) * sizeof(T));
+			SubArray(y, n, m.Entry(1), m.EntrySize(1));
+		}
+	}
+	delete[] u;
+	return nu;
+}
+
+/**Raise an array to a power by squaring.
+\param r [out] The power.  Must have room for na e units.
+\param a The array.
+\param na The size of a.
+\param e The exponent.  Must not be zero.
+\param t Work space, na e units.
+\return The real size of the power.*/
+template<typename T>
+inline std::size_t PowArray(T* r, const T* a, std::size_t na, std::size_t e,
+	T* t)
+{
+	T* const out = r;
+	na = RealSize(a, na);
+	ZeroOut(r, na * e);
+	std::memcpy(r, a, na * sizeof(T));
+	std::size_t nr = na;
+	if (na == 0)
+		return 0;
+	std::size_t bit = 0;
+	for (std::size_t i = e; i > 1; i >>= 1)
+		++bit;
+	while (bit--)
+	{
+		ZeroOut(t, nr + nr);
+		SqrArray(t, r, nr);
+		std::swap(r, t);
+		nr = RealSize(r, nr + nr);
+		if ((e >> bit) & 1)
+		{
+			ZeroOut(t, nr + na);
+			MulArray(t, r, nr, a, na);
+			std::swap(r, t);
+			nr = RealSize(r, nr + na);
+		}
+	}
+	if (r != out)
+		std::memcpy(out, r, nr * sizeof(T));
+	return nr;
+}
+/**Square root and remainder with Newton's method, dividing in full each
+step.  Used for small arrays.
+\param s [out] floor(sqrt(a)).  Must have room for n / 2 + 1 units.
+\param r [out] a - s^2.  Must have room for n units.
+\param a The array.
+\param n The size of a.*/
+template<typename T>
+inline void SqrtRemArray_Newton(T* s, T* r, const T* a, std::size_t n)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	const std::size_t ns = n / 2 + 1;
+	ZeroOut(s, ns);
+	ZeroOut(r, n);
+	n = RealSize(a, n);
+	if (n == 0)
+		return;
+	T* x = new T[ns + (n + 1) + (ns + ns)];
+	T* y = x + ns;
+	T* t = y + n + 1;
+	/*Start at or above the root so the steps go down to it.*/
+	const std::size_t bits = (MSBNumber(a, n) + 1) / 2;
+	ZeroOut(x, ns);
+	x[bits / TBits] = T(T(1) << (bits % TBits));
+	for (;;)
+	{
+		/*y = (x + a / x) / 2*/
+		std::memcpy(y, a, n * sizeof(T));
+		y[n] = 0;
+		DivArray_Knuth(y, n + 1, x, ns, (T*)nullptr);
+		AddArray(y, n + 1, x, ns);
+		ShiftInsigB(y, n + 1, 1);
+		if (CompareArray(y, RealSize(y, n + 1), x, RealSize(x, ns)) != -1)
+			break;
+		std::memcpy(x, y, ns * sizeof(T));
+	}
+	std::memcpy(s, x, ns * sizeof(T));
+	const std::size_t nx = RealSize(x, ns);
+	ZeroOut(t, ns + ns);
+	if (nx)
+		SqrArray(t, x, nx);
+	std::memcpy(r, a, n * sizeof(T));
+	SubArray(r, n, t, nx + nx);
+	delete[] x;
+}
+/**Square root and remainder of a normalized array (Zimmermann's Karatsuba
+square root).  The root of the top half is found recursively and the rest
+of the root comes from one division by it, so the cost follows that of
+multiplication.
+\param s [out] floor(sqrt(a)), m units.
+\param r [out] a - s^2, m + 1 units.
+\param a The array, 2 m units.  The top unit must be at least B / 4.
+\param m Half the size of a.*/
+template<typename T>
+inline void SqrtRemArray_Core(T* s, T* r, const T* a, const std::size_t m)
+{
+	if (m < 3)
+	{
+		T* t = new T[m + 1 + m + m];
+		SqrtRemArray_Newton(t, t + m + 1, a, m + m);
+		std::memcpy(s, t, m * sizeof(T));
+		std::memcpy(r, t + m + 1, (m + 1) * sizeof(T));
+		delete[] t;
+		return;
+	}
+	/*a = a3 B^(2k) + a1 B^k + a0, with a3 of 2h units.*/
+	const std::size_t k = m / 2;
+	const std::size_t h = m - k;
+	T* w = new T[h + (h + 1) + (m + 1) + (h + 1) + (m + 1) + (m + 1)
+		+ (m + 2) + (k + k + 2)];
+	T* s1 = w;
+	T* r1 = s1 + h;
+	T* q = r1 + h + 1;
+	T* d = q + m + 1;
+	T* u = d + h + 1;
+	T* st = u + m + 1;
+	T* rt = st + m + 1;
+	T* q2 = rt + m + 2;
+	SqrtRemArray_Core(s1, r1, a + k + k, h);
+	/*q, u = (r1 B^k + a1) / (2 s1)*/
+	std::memcpy(q, a + k, k * sizeof(T));
+	std::memcpy(q + k, r1, (h + 1) * sizeof(T));
+	std::memcpy(d, s1, h * sizeof(T));
+	d[h] = 0;
+	ShiftSigB(d, h + 1, 1);
+	DivArray_Split(q, m + 1, d, h + 1, u);
+	/*s = s1 B^k + q*/
+	ZeroOut(st, m + 1);
+	std::memcpy(st + k, s1, h * sizeof(T));
+	AddArray(st, m + 1, q, k + 1);
+	/*r = u B^k + a0 - q^2, going back one on s if it is negative.*/
+	ZeroOut(rt, m + 2);
+	std::memcpy(rt, a, k * sizeof(T));
+	std::memcpy(rt + k, u, (h + 1) * sizeof(T));
+	ZeroOut(q2, k + k + 2);
+	const std::size_t nq = RealSize(q, k + 1);
+	if (nq)
+		SqrArray(q2, q, nq);
+	if (CompareArray(rt, RealSize(rt, m + 2), q2, RealSize(q2, k + k + 2))
+		== -1)
+	{
+		AddArray(rt, m + 2, st, m + 1);
+		AddArray(rt, m + 2, st, m + 1);
+		SubArray(rt, m + 2, T(1));
+		SubArray(st, m + 1, T(1));
+	}
+	SubArray(rt, m + 2, q2, k + k + 2);
+	std::memcpy(s, st, m * sizeof(T));
+	std::memcpy(r, rt, (m + 1) * sizeof(T));
+	delete[] w;
+}
+/**Find the integer square root of an array and the remainder.
+\param s [out] floor(sqrt(a)).  Must have room for (n + 1) / 2 units.
+\param r [out] a - s^2, or nullptr.  Must have room for n units.
+\param a The array.
+\param n The size of a.
+\return The real size of s.*/
+template<typename T>
+inline std::size_t SqrtRemArray(T* s, T* r, const T* a, std::size_t n)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	const std::size_t ns = (n + 1) / 2;
+	ZeroOut(s, ns);
+	if (r)
+		ZeroOut(r, n);
+	const std::size_t na = RealSize(a, n);
+	if (na == 0)
+		return 0;
+	/*Shift by an even amount so the top unit of 2m units is at least
+	B / 4, then shift the root back by half as much.*/
+	const std::size_t m = (na + 1) / 2;
+	const std::size_t c = (m * 2 * TBits - MSBNumber(a, na)) & ~std::size_t(1);
+	T* w = new T[m + m + m + (m + 1)];
+	T* an = w;
+	T* sn = an + m + m;
+	T* rn = sn + m;
+	ZeroOut(an, m + m);
+	std::memcpy(an, a, na * sizeof(T));
+	ShiftSigB(an, m + m, c);
+	SqrtRemArray_Core(sn, rn, an, m);
+	ShiftInsigB(sn, m, c / 2);
+	std::memcpy(s, sn, m * sizeof(T));
+	const std::size_t nsn = RealSize(sn, m);
+	if (r && c == 0)
+		std::memcpy(r, rn, (m + 1 < n ? m + 1 : n) * sizeof(T));
+	else if (r)
+	{
+		ZeroOut(an, m + m);
+		SqrArray(an, sn, nsn);
+		std::memcpy(r, a, na * sizeof(T));
+		SubArray(r, na, an, m + m < na ? m + m : na);
+	}
+	delete[] w;
+	return nsn;
+}
+/**Find the integer k-th root of an array with Newton's method, starting
+above the root so each step goes down to it.  The start comes from the root of
+the top half of the bits, so the cost follows that of division.
+\param s [out] floor(a^(1/k)).  Must have room for n / k + 1 units.
+\param a The array.
+\param n The size of a.
+\param k The root.  Must not be zero.
+\return The real size of s.*/
+template<typename T>
+inline std::size_t RootArray(T* s, const T* a, std::size_t n,
+	const std::size_t k)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	if (k == 0)
+		throw std::invalid_argument("Root is zero.");
+	ZeroOut(s, n / k + 1);
+	n = RealSize(a, n);
+	if (n == 0)
+		return 0;
+	const std::size_t bits = MSBNumber(a, n);
+	if (k >= bits)
+	{
+		s[0] = 1;
+		return 1;
+	}
+	if (k == 1)
+	{
+		std::memcpy(s, a, n * sizeof(T));
+		return n;
+	}
+	if (k == 2)
+		return SqrtRemArray(s, (T*)nullptr, a, n);
+	/*k and k - 1 may not fit in a unit, so they are split over a few.*/
+	const std::size_t nk = (sizeof(uint64_t) + sizeof(T) - 1) / sizeof(T);
+	T kd[sizeof(uint64_t)];
+	T km[sizeof(uint64_t)];
+	for (std::size_t i = 0; i < nk; ++i)
+	{
+		kd[i] = T(uint64_t(k) >> (i * TBits));
+		km[i] = T(uint64_t(k - 1) >> (i * TBits));
+	}
+	const std::size_t sk = RealSize(kd, nk);
+	const std::size_t sm = RealSize(km, nk);
+	const std::size_t bx = (bits + k - 1) / k;
+	const std::size_t nx = bx / TBits + 1;
+	const std::size_t np = nx * (k - 1);
+	const std::size_t nq = (n > nx ? n : nx) + nk + 1;
+	T* x = new T[nx + (nx + nk) + np + np + nq];
+	T* y = x + nx;
+	T* p = y + nx + nk;
+	T* t = p + np;
+	T* q = t + np;
+	ZeroOut(x, nx);
+	if (bx > TBits + TBits)
+	{
+		/*Start from the root of the top bits, (root(a / 2^(k j)) + 1) 2^j,
+		so only a few steps are taken at full size.*/
+		const std::size_t j = bx / 2;
+		T* h = new T[n + n / k + 1];
+		T* hr = h + n;
+		std::memcpy(h, a, n * sizeof(T));
+		ShiftInsigB(h, n, k * j);
+		std::memcpy(x, hr, RootArray(hr, h, n, k) * sizeof(T));
+		delete[] h;
+		AddArray(x, nx, T(1));
+		ShiftSigB(x, nx, j);
+	}
+	else
+		x[bx / TBits] = T(T(1) << (bx % TBits));
+	for (;;)
+	{
+		/*y = ((k - 1) x + a / x^(k-1)) / k*/
+		const std::size_t sp = PowArray(p, x, nx, k - 1, t);
+		std::memcpy(q, a, n * sizeof(T));
+		ZeroOut(q + n, nq - n);
+		if (CompareArray(p, sp, a, n) == 1)
+			ZeroOut(q, nq);
+		else
+			DivArray_Knuth(q, nq, p, sp, (T*)nullptr);
+		MulArray(y, x, nx, km, sm);
+		AddArray(q, nq, y, nx + sm);
+		if (sk == 1)
+			DivArray(q, nq, kd[0]);
+		else
+			DivArray_Knuth(q, nq, kd, sk, (T*)nullptr);
+		if (CompareArray(q, RealSize(q, nq), x, RealSize(x, nx)) != -1)
+			break;
+		std::memcpy(x, q, nx * sizeof(T));
+	}
+	const std::size_t sx = RealSize(x, nx);
+	std::memcpy(s, x, sx * sizeof(T));
+	delete[] x;
+	return sx;
+}
+
 }
\ No newline at end of file
@@ -21,7 +21,9 @@ along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <stdexcept>
+#include <type_traits>
 
 #include "List.hpp"
 #include "BasicMathFuncs.hpp"
@@ -32,6 +34,9 @@ namespace cg {
 /////////////////////////////////////////////////////////////////////////////////INTIMPL HERE//////
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+template<typename DataType, std::size_t Units>
+class BarrettReducer;
+
 template<typename DataType, std::size_t Units>
 class BigNum
 {
@@ -72,8 +77,40 @@ public:
 		mf_digitShiftMSDFunc = other.mf_digitShiftMSDFunc;
 		mf_divFunc = other.mf_divFunc;
 		mf_mulFunc = other.mf_mulFunc;
+		mf_sqrFunc = other.mf_sqrFunc;
 		mf_subFunc = other.mf_subFunc;
 	};
+	/**Copy a bignum.
+	\param other The thing to copy.
+	\return A reference to this.*/
+	Self& operator=(const Self& other)
+	{
+		if (this == &other)
+			return *this;
+		m_data = other.m_data.Copy();
+		mf_addFunc = other.mf_addFunc;
+		mf_compFunc = other.mf_compFunc;
+		mf_digitShiftLSBFunc = other.mf_digitShiftLSBFunc;
+		mf_digitShiftLSDFunc = other.mf_digitShiftLSDFunc;
+		mf_digitShiftMSBFunc = other.mf_digitShiftMSBFunc;
+		mf_digitShiftMSDFunc = other.mf_digitShiftMSDFunc;
+		mf_divFunc = other.mf_divFunc;
+		mf_mulFunc = other.mf_mulFunc;
+		mf_sqrFunc = other.mf_sqrFunc;
+		mf_subFunc = other.mf_subFunc;
+		return *this;
+	}
+	/**Set the value to a single digit.  The size of the number is kept.
+	\param n The value.
+	\return A reference to this.*/
+	Self& operator=(const DataType& n)
+	{
+		if (Size() == 0)
+			m_data.PushBack(DataType(0));
+		cg::ZeroOut(Begin(), Size());
+		Set(0, n);
+		return *this;
+	}
 	/**Default for empty number.*/
 	BigNum()
 	{
@@ -150,7 +187,8 @@ public:
 	\return A reference to this.*/
 	Self& operator+=(const DataType& r)
 	{
-		(mf_addFunc)(Begin(), Size(), &r, 1);
+		if ((mf_addFunc)(Begin(), Size(), &r, 1) && m_data.CanInsert())
+			m_data.PushBack(DataType(1));
 		return *this;
 	}
 	/**Do a math operation.
@@ -159,7 +197,10 @@ public:
 	template<typename U, std::size_t S>
 	Self& operator+=(const BigNum<U,S>& r)
 	{
-		(mf_addFunc)(Begin(), Size(), r.Begin(), r.Size());
+		ExpandTo(r.RealSize());
+		if ((mf_addFunc)(Begin(), Size(), r.Begin(), r.RealSize())
+			&& m_data.CanInsert())
+			m_data.PushBack(DataType(1));
 		return *this;
 	}
 	/**Do a math operation.
@@ -179,17 +220,32 @@ public:
 		(mf_subFunc)(Begin(), Size(), r.Begin(), r.Size());
 		return *this;
 	}
-	/**Do a math operation.
-	\param r The thing to operate on this with.
+	/**Multiply by a digit in place, in one pass and without allocating
+	unless the carry needs a new digit.
+	\param r The digit to multiply by.
 	\return A reference to this.*/
 	Self& operator*=(const DataType& r)
 	{
-		if (m_data.CanInsert() && RealSize() == Size())
-		{
-			m_data.PushBack(0);
-			m_data.Get(Size() - 1) = 0;
-		}
-		(mf_mulFunc)(Begin(), Size(), &r, 1);
+		const DataType carry = cg::MulArray(Begin(), Size(), r);
+		if (carry && m_data.CanInsert())
+			m_data.PushBack(DataType(carry));
+		return *this;
+	}
+	/**Multiply by a native 64 bit number when the digits are smaller, in
+	place and without a temporary.  See cg::MulSmallInPlace.
+	\param r The number to multiply by.
+	\return A reference to this.*/
+	template<typename U, typename = typename std::enable_if<
+		std::is_same<U, uint64_t>::value
+		&& !std::is_same<U, DataType>::value>::type>
+	Self& operator*=(const U& r)
+	{
+		const std::size_t k = sizeof(U) / sizeof(DataType);
+		DataType b[k];
+		for (std::size_t i = 0; i < k; ++i)
+			b[i] = DataType(r >> (i * sizeof(DataType) * 8));
+		ExpandTo(RealSize() + cg::RealSize(b, k));
+		cg::MulSmallInPlace(Begin(), Size(), b, k);
 		return *this;
 	}
 	/**Do a math operation.
@@ -198,13 +254,42 @@ public:
 	template<typename U, std::size_t S>
 	Self& operator*=(const BigNum<U, S>& r)
 	{
-		auto newSize = (RealSize() + r.Size());
-		while (Size() < newSize && m_data.CanInsert())
+		if ((const void*)this == (const void*)&r)
+			return Square();
+		/*Fixed size numbers use all their digits so the product is only
+		truncated when it has to be.*/
+		ExpandTo(Units ? Units : RealSize() + r.RealSize());
+		(mf_mulFunc)(Begin(), Size(), r.Begin(), r.RealSize());
+		return *this;
+	}
+	/**Add a number times a digit to this number in one pass, without a
+	temporary for the product.
+	\param a The number to multiply.  May be this number.
+	\param m The digit to multiply by.
+	\return A reference to this.*/
+	template<std::size_t S>
+	Self& AddMul(const BigNum<DataType, S>& a, const DataType& m)
+	{
+		ExpandTo(a.RealSize());
+		const std::size_t n = a.RealSize() < Size() ? a.RealSize() : Size();
+		const DataType carry = cg::AddMulArray(Begin(), a.Begin(), n, m);
+		if (n < Size())
 		{
-			m_data.PushBack(0);
-			m_data.Get(Size() - 1) = 0;
+			if (cg::AddArray(Begin() + n, Size() - n, carry)
+				&& m_data.CanInsert())
+				m_data.PushBack(DataType(1));
 		}
-		(mf_mulFunc)(Begin(), Size(), r.Begin(), r.RealSize());
+		else if (carry && m_data.CanInsert())
+			m_data.PushBack(carry);
+		return *this;
+	}
+	/**Square this number.  Faster than multiplying by a different number
+	of the same size.
+	\return A reference to this.*/
+	Self& Square()
+	{
+		ExpandTo(Units ? Units : RealSize() + RealSize());
+		(mf_sqrFunc)(Begin(), Size());
 		return *this;
 	}
 	/**Do a math operation.
@@ -212,7 +297,7 @@ public:
 	\return A reference to this.*/
 	Self& operator/=(const DataType& r)
 	{
-		(mf_divFunc)(Begin(), RealSize(), &r, 1, nullptr);
+		cg::DivArray(Begin(), RealSize(), r);
 		return *this;
 	}
 	/**Do a math operation.
@@ -229,12 +314,7 @@ public:
 	\return A reference to this.*/
 	Self& operator%=(const DataType& r)
 	{
-		/**The real size will change after the division.*/
-		auto tCopyAmt = RealSize();
-		DataType* t = new DataType[RealSize()];
-		(mf_divFunc)(Begin(), RealSize(), &r, 1, t);
-		std::memmove(Begin(), t, tCopyAmt * sizeof(DataType));
-		return *this;
+		return *this = DivMod(r);
 	}
 	/**Do a math operation.
 	\param r The thing to operate on this with.
@@ -242,13 +322,76 @@ public:
 	template<typename U, std::size_t S>
 	Self& operator%=(const BigNum<U, S>& r)
 	{
-		/**The real size will change after the division.*/
-		auto tCopyAmt = RealSize();
-		DataType* t = new DataType[RealSize()];
-		(mf_divFunc)(Begin(), RealSize(), r.Begin(), r.RealSize(), t);
-		std::memmove(Begin(), t, tCopyAmt * sizeof(DataType));
+		if ((const void*)&r == (const void*)this && !IsZero())
+		{
+			cg::ZeroOut(Begin(), Size());
+			return *this;
+		}
+		/*The quotient is found in the low half of this and the remainder in
+		the high half, then the size goes back to what it was.  The storage
+		is kept, so nothing is allocated once it has held twice the real
+		size.*/
+		const std::size_t size = Size();
+		const std::size_t n = RealSize() + 1;
+		ExpandTo(n + n);
+		if (Size() < n + n)
+		{
+			Self q;
+			DivMod(r, q, *this);
+			return *this;
+		}
+		DataType* a = Begin();
+		(mf_divFunc)(a, n, r.Begin(), r.RealSize(), a + n);
+		std::memcpy(a, a + n, n * sizeof(DataType));
+		cg::ZeroOut(a + n, Size() - n);
+		m_data.PopBack(Size() - size);
+		return *this;
+	}
+	/**Reduce this by the modulus of a reducer.  Cheaper than dividing
+	when the same modulus is used many times.
+	\param r The reducer.  Include Barrett.hpp to use this.
+	\return A reference to this.*/
+	template<std::size_t S>
+	Self& operator%=(BarrettReducer<DataType, S>& r)
+	{
+		r.Reduce(*this);
 		return *this;
 	}
+	/**Divide this by a single digit.
+	\param r The divisor.
+	\return The remainder.*/
+	DataType DivMod(const DataType& r)
+	{
+		return cg::DivArray(Begin(), RealSize(), r);
+	}
+	/**Find the quotient and the remainder of this divided by another number
+	in one pass.  Nothing is allocated once q and r have room for one digit
+	more than this (or when the divide function allocates nothing, see
+	cg::DivArray_Knuth).
+	\param d The divisor.
+	\param q [out] The quotient.  May be this or d, must not be r.
+	\param r [out] The remainder.  May be this or d, must not be q.*/
+	template<typename U, std::size_t S>
+	void DivMod(const BigNum<U, S>& d, Self& q, Self& r) const
+	{
+		/*q and r are written before d is read, so a divisor that is one of
+		them is copied first.*/
+		if ((const void*)&d == (const void*)&q
+			|| (const void*)&d == (const void*)&r)
+		{
+			const BigNum<U, S> copy = d;
+			DivMod(copy, q, r);
+			return;
+		}
+		const std::size_t n = RealSize();
+		q.ExpandTo(n + 1);
+		r.ExpandTo(n + 1);
+		std::memmove(q.Begin(), Begin(), n * sizeof(DataType));
+		cg::ZeroOut(q.Begin() + n, q.Size() - n);
+		cg::ZeroOut(r.Begin(), r.Size());
+		const std::size_t s = q.Size() < r.Size() ? q.Size() : r.Size();
+		(mf_divFunc)(q.Begin(), s, d.Begin(), d.RealSize(), r.Begin());
+	}
 	/**Do a math operation.
 	\return A copy of this before incrementing.*/
 	Self operator++(int)
@@ -477,6 +620,16 @@ public:
 		for (; beg != end; ++beg)
 			*beg = ~(*beg);
 	}
+	/**Add MSD side zeros until there are `amt` digits, or until the storage
+	is full.
+	\param amt The amount of digits to hold.*/
+	void ExpandTo(std::size_t amt)
+	{
+		if (Units == 0 && amt > Size())
+			m_data.Reserve(amt);
+		while (Size() < amt && m_data.CanInsert())
+			m_data.PushBack(DataType(0));
+	}
 	/**Trim off any non-value effecting zeroes.*/
 	void TrimMSDZeros()
 	{
@@ -531,10 +684,10 @@ public:
 		return *this;
 	}
 	
-private:
-	/**The list to hold data*/
-	cg::List<DataType, Units> m_data;
-private:
+	///////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////FUNCTION SELECTION HERE//
+	///////////////////////////////////////////////////////////////////////////
+
 	/**The type of math function pointers.*/
 	using MathFuncPtr
 		= bool(*)(DataType*, const std::size_t, 
@@ -550,14 +703,43 @@ private:
 	/**The type of shifter function pointers.*/
 	using ShiftFuncPtr
 		= void(*)(DataType*, const std::size_t, const std::size_t);
+	/**The type of squaring function pointers.*/
+	using SqrFuncPtr = bool(*)(DataType*, const std::size_t);
+	/**Set the function used for multiplying.  The default picks the
+	algorithm by size, see cg::Thresholds.
+	\param f The function to call for multiplying the arrays.*/
+	void SetMulFunc(MathFuncPtr f)
+	{
+		mf_mulFunc = f;
+	}
+	/**Set the function used for dividing.  The default is Knuth algorithm
+	D, cg::DivArray_Split is faster for divisors of many units.
+	\param f The function to call for dividing the arrays.*/
+	void SetDivFunc(DivFuncPtr f)
+	{
+		mf_divFunc = f;
+	}
+	/**Set the function used for squaring.  The default picks the
+	algorithm by size, see cg::Thresholds.
+	\param f The function to call for squaring the array.*/
+	void SetSqrFunc(SqrFuncPtr f)
+	{
+		mf_sqrFunc = f;
+	}
+private:
+	/**The list to hold data*/
+	cg::List<DataType, Units> m_data;
+private:
 	/**The function to call for adding the arrays*/
 	MathFuncPtr mf_addFunc = &cg::AddArray;
 	/**The function to call for subtracting the arrays*/
 	MathFuncPtr mf_subFunc = &cg::SubArray;
 	/**The function to call for multiplying the arrays*/
 	MathFuncPtr mf_mulFunc = &cg::MulArray;
+	/**The function to call for squaring the array*/
+	SqrFuncPtr mf_sqrFunc = &cg::SqrArray;
 	/**The function to call for dividing the arrays*/
-	DivFuncPtr mf_divFunc = &cg::DivArray_Shift;
+	DivFuncPtr mf_divFunc = &cg::DivArray_Knuth;
 	/**The function to call for comparing the arrays*/
 	CompareFuncPtr mf_compFunc = &cg::CompareArray;
 	/**The function to call for shifting the arrays*/
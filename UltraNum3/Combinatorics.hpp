@@ -0,0 +1,243 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "BigNum.hpp"
+#include "Sieve.hpp"
+
+namespace cg {
+
+/**Multiply a list of 64 bit numbers with a balanced product tree, so the
+big multiplications have operands of about the same size and run on the fast
+multiplication kernels.
+\param r [out] The product.  Must have room for count L units, where L is
+the amount of units in 64 bits.
+\param v The numbers.
+\param count The amount of numbers.  Must not be zero.
+\param t Work space, (2 count + 64) L units.
+\return The real size of the product.*/
+template<typename T>
+inline std::size_t ProductArray(T* r, const uint64_t* v,
+	const std::size_t count, T* t)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	const std::size_t L = (64 + TBits - 1) / TBits;
+	if (count == 1)
+	{
+		ZeroOut(r, L);
+		WriteBits(r, L, 0, 64, v[0]);
+		return RealSize(r, L);
+	}
+	const std::size_t h = count / 2;
+	T* left = t;
+	T* right = t + h * L;
+	const std::size_t nl = ProductArray(left, v, h, t + count * L);
+	const std::size_t nr = ProductArray(right, v + h, count - h,
+		t + count * L);
+	ZeroOut(r, count * L);
+	if (nl == 0 || nr == 0)
+		return 0;
+	MulArray(r, left, nl, right, nr);
+	return RealSize(r, nl + nr);
+}
+/**Multiply a list of 64 bit numbers with a balanced product tree (see
+ProductArray).  Runs of small numbers are first multiplied together while they
+fit in 64 bits.
+\param v The numbers.
+\param count The amount of numbers.
+\return The product, 1 when the list is empty.*/
+template<typename DataType, std::size_t Units = 0>
+BigNum<DataType, Units> Product(const uint64_t* v, const std::size_t count)
+{
+	const std::size_t TBits = sizeof(DataType) * 8;
+	const std::size_t L = (64 + TBits - 1) / TBits;
+	uint64_t* leaves = new uint64_t[count + 1];
+	std::size_t n = 0;
+	uint64_t acc = 1;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (v[i] != 0 && acc > ~uint64_t(0) / v[i])
+		{
+			leaves[n++] = acc;
+			acc = 1;
+		}
+		acc *= v[i];
+	}
+	leaves[n++] = acc;
+	DataType* r = new DataType[n * L + (2 * n + 64) * L];
+	const std::size_t nr = ProductArray(r, leaves, n, r + n * L);
+	BigNum<DataType, Units> ret;
+	if (nr)
+		ret.PushArray(r, nr);
+	else
+		ret = DataType(0);
+	delete[] r;
+	delete[] leaves;
+	return ret;
+}
+/**Find the prime swing of a number, n! / (n/2)!^2 (Luschny).  Each prime p
+up to n is in it p^e times, with e the amount of odd numbers in n / p,
+n / p^2, ..., and p^e is never more than n.
+\param n The number.
+\param primes The primes up to n.
+\param np The amount of primes.
+\return The swing.*/
+template<typename DataType>
+BigNum<DataType, 0> PrimeSwing(const uint64_t n, const uint32_t* primes,
+	const std::size_t np)
+{
+	uint64_t* v = new uint64_t[np + 1];
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < np && primes[i] <= n; ++i)
+	{
+		const uint64_t p = primes[i];
+		uint64_t pe = 1;
+		for (uint64_t q = n / p; q; q /= p)
+			if (q & 1)
+				pe *= p;
+		if (pe > 1)
+			v[count++] = pe;
+	}
+	BigNum<DataType, 0> r = Product<DataType>(v, count);
+	delete[] v;
+	return r;
+}
+/**Find a factorial with the prime swing: n! = (n/2)!^2 swing(n), so most of
+the work is squaring and the swings are balanced product trees.
+\param n The number.  Must be below 2^32.
+\return n!*/
+template<typename DataType, std::size_t Units = 0>
+BigNum<DataType, Units> Factorial(const uint64_t n)
+{
+	/*Below 21 the factorial fits in 64 bits.*/
+	uint64_t small = 1;
+	std::size_t top = 0;
+	while ((n >> top) > 20)
+		++top;
+	for (uint64_t i = 2; i <= (n >> top); ++i)
+		small *= i;
+	BigNum<DataType, 0> r = Product<DataType>(&small, 1);
+	if (top)
+	{
+		std::size_t np;
+		uint32_t* primes = PrimeTable(n + 1, np);
+		while (top--)
+		{
+			r.Square();
+			r *= PrimeSwing<DataType>(n >> top, primes, np);
+		}
+		delete[] primes;
+	}
+	BigNum<DataType, Units> ret;
+	ret.PushArray(r.Begin(), r.RealSize());
+	return ret;
+}
+/**Find a binomial coefficient.  When k is a good part of n, the primes up to
+n are sieved and each prime p is taken p^e times with e the amount of borrows
+when subtracting k from n in base p (Kummer).  Otherwise the falling factorial
+of n is found with a product tree and divided by k!.
+\param n The top.
+\param k The bottom.
+\return n choose k, 0 when k is more than n.*/
+template<typename DataType, std::size_t Units = 0>
+BigNum<DataType, Units> Binomial(const uint64_t n, uint64_t k)
+{
+	BigNum<DataType, Units> ret;
+	if (k > n)
+	{
+		ret = DataType(0);
+		return ret;
+	}
+	if (k > n - k)
+		k = n - k;
+	BigNum<DataType, 0> r;
+	if (k && n <= (uint64_t(1) << 32) - 1 && k >= n / 16)
+	{
+		std::size_t np;
+		uint32_t* primes = PrimeTable(n + 1, np);
+		uint64_t* v = new uint64_t[np + 1];
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < np; ++i)
+		{
+			const uint64_t p = primes[i];
+			uint64_t pe = 1;
+			/*Count the borrows of n - k in base p.*/
+			uint64_t a = n;
+			uint64_t b = k;
+			unsigned borrow = 0;
+			while (a)
+			{
+				const uint64_t da = a % p;
+				const uint64_t db = b % p + borrow;
+				borrow = da < db ? 1 : 0;
+				if (borrow)
+					pe *= p;
+				a /= p;
+				b /= p;
+			}
+			if (pe > 1)
+				v[count++] = pe;
+		}
+		r = Product<DataType>(v, count);
+		delete[] v;
+		delete[] primes;
+	}
+	else
+	{
+		uint64_t* v = new uint64_t[k + 1];
+		for (uint64_t i = 0; i < k; ++i)
+			v[i] = n - i;
+		BigNum<DataType, 0> num = Product<DataType>(v, std::size_t(k));
+		delete[] v;
+		BigNum<DataType, 0> rem;
+		num.DivMod(Factorial<DataType>(k), r, rem);
+	}
+	ret.PushArray(r.Begin(), r.RealSize());
+	if (ret.RealSize() == 0)
+		ret = DataType(0);
+	return ret;
+}
+/**Find a primorial, the product of the primes up to a number, with a product
+tree.
+\param n The number.  Must be below 2^32.
+\return n#*/
+template<typename DataType, std::size_t Units = 0>
+BigNum<DataType, Units> Primorial(const uint64_t n)
+{
+	std::size_t np;
+	uint32_t* primes = PrimeTable(n + 1, np);
+	uint64_t* v = new uint64_t[np + 1];
+	for (std::size_t i = 0; i < np; ++i)
+		v[i] = primes[i];
+	BigNum<DataType, Units> r = Product<DataType, Units>(v, np);
+	delete[] v;
+	delete[] primes;
+	return r;
+}
+
+}
@@ -0,0 +1,284 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+#include "BigNum.hpp"
+#include "Combinatorics.hpp"
+#include "Roots.hpp"
+
+namespace cg {
+
+/**The sums of a run of series terms, see BinarySplit.
+\tparam DataType The type of the digits.*/
+template<typename DataType>
+struct SplitSums
+{
+	/**The product of the p(k).*/
+	BigNum<DataType, 0> p;
+	/**True if p is negative.*/
+	bool pNeg = false;
+	/**The product of the q(k).*/
+	BigNum<DataType, 0> q;
+	/**The sum of the terms times q, see BinarySplit.*/
+	BigNum<DataType, 0> t;
+	/**True if t is negative.*/
+	bool tNeg = false;
+};
+/**Add a signed number to another.
+\param a The number to add to.  Will be the answer.
+\param aNeg The sign of a.  True if a is negative.
+\param b The number to add.
+\param bNeg The sign of b.  True if b is negative.*/
+template<typename DataType>
+void AddSigned(BigNum<DataType, 0>& a, bool& aNeg,
+	const BigNum<DataType, 0>& b, const bool bNeg)
+{
+	if (aNeg == bNeg)
+		a += b;
+	else if (CompareArray(a.Begin(), a.RealSize(), b.Begin(), b.RealSize())
+		>= 0)
+		a -= b;
+	else
+	{
+		BigNum<DataType, 0> t = b;
+		t -= a;
+		a = t;
+		aNeg = bNeg;
+	}
+}
+/**Sum the terms [n1, n2) of a hypergeometric series with binary splitting.
+The series is the sum of a(n) p(0)...p(n) / (q(0)...q(n)).  Each half is
+summed recursively and the halves are joined with
+P = Pl Pr, Q = Ql Qr and T = Tl Qr + Pl Tr, so the sum is T / Q and the big
+multiplications have operands of about the same size.
+\param n1 The first term.
+\param n2 One past the last term.  Must be more than n1.
+\param term The terms, `term(n, p, pNeg, q, a)` sets p(n), its sign, q(n) and
+a(n).
+\param r [out] The sums.
+\param needP False if the product of the p(k) is not needed, as for the
+last run of the series.*/
+template<typename DataType, typename F>
+void BinarySplit(const uint64_t n1, const uint64_t n2, F& term,
+	SplitSums<DataType>& r, const bool needP = true)
+{
+	if (n2 - n1 == 1)
+	{
+		term(n1, r.p, r.pNeg, r.q, r.t);
+		r.t *= r.p;
+		r.tNeg = r.pNeg;
+		return;
+	}
+	const uint64_t m = n1 + (n2 - n1) / 2;
+	SplitSums<DataType> right;
+	BinarySplit(n1, m, term, r, true);
+	BinarySplit(m, n2, term, right, needP);
+	r.t *= right.q;
+	right.t *= r.p;
+	AddSigned(r.t, r.tNeg, right.t, r.pNeg != right.tNeg);
+	r.q *= right.q;
+	if (needP)
+	{
+		r.p *= right.p;
+		r.pNeg = r.pNeg != right.pNeg;
+	}
+}
+/**Find 10^n.
+\param n The power.
+\return 10^n.*/
+template<typename DataType>
+BigNum<DataType, 0> PowerOfTen(const std::size_t n)
+{
+	BigNum<DataType, 0> r;
+	r = DataType(10);
+	return PowInPlace(r, n);
+}
+/**Find a m / b to a set precision.  The sums of a series are far bigger
+than the precision they give, so a and b are first cut down to their top
+units, which makes the division much smaller.
+\param a The numerator.
+\param b The denominator.  Must not be zero.
+\param m What to scale a by.
+\param digits The amount of decimal digits of precision needed.  The answer
+is off by at most 2 when a / b has fewer digits before the point than
+the guard digits.
+\return About a m / b.*/
+template<typename DataType>
+BigNum<DataType, 0> TruncatedQuotient(const BigNum<DataType, 0>& a,
+	const BigNum<DataType, 0>& b, const BigNum<DataType, 0>& m,
+	const std::size_t digits)
+{
+	const std::size_t units = std::size_t(double(digits) * 3.3219280948873623
+		/ double(sizeof(DataType) * 8)) + 2;
+	const std::size_t bs = b.RealSize();
+	const std::size_t shift = bs > units ? bs - units : 0;
+	BigNum<DataType, 0> x;
+	BigNum<DataType, 0> y;
+	if (a.RealSize() > shift)
+		x.PushArray(a.Begin() + shift, a.RealSize() - shift);
+	else
+		x = DataType(0);
+	y.PushArray(b.Begin() + shift, bs - shift);
+	x *= m;
+	x.SetDivFunc(&DivArray_Newton<DataType>);
+	BigNum<DataType, 0> q;
+	BigNum<DataType, 0> r;
+	x.DivMod(y, q, r);
+	return q;
+}
+/**Finish a constant found with guard digits: drop the guard digits.
+\param x The constant times 10^(digits + guard).
+\param guard The amount of guard digits.
+\return The constant times 10^digits, rounded down.*/
+template<typename DataType>
+BigNum<DataType, 0> DropGuardDigits(const BigNum<DataType, 0>& x,
+	const std::size_t guard)
+{
+	BigNum<DataType, 0> q;
+	BigNum<DataType, 0> r;
+	x.DivMod(PowerOfTen<DataType>(guard), q, r);
+	return q;
+}
+/**The amount of guard digits the constants are found with.  The last digits
+are only wrong when the digits after them are a long run of 9s or 0s.*/
+const std::size_t ConstantGuardDigits = 16;
+/**Find pi with the Chudnovsky series, summed with binary splitting.  Each
+term adds about 14 digits.
+\param digits The amount of digits after the decimal point.
+\return floor(pi 10^digits).*/
+template<typename DataType>
+BigNum<DataType, 0> Pi(const std::size_t digits)
+{
+	const std::size_t d = digits + ConstantGuardDigits;
+	const uint64_t terms = uint64_t(double(d) / 14.181647462725477) + 2;
+	/*p(k) = -(6k - 5)(2k - 1)(6k - 1), q(k) = k^3 640320^3 / 24,
+	a(k) = 13591409 + 545140134 k*/
+	auto term = [](const uint64_t k, BigNum<DataType, 0>& p, bool& pNeg,
+		BigNum<DataType, 0>& q, BigNum<DataType, 0>& a)
+	{
+		const uint64_t vp[3] = { 6 * k - 5, 2 * k - 1, 6 * k - 1 };
+		const uint64_t vq[4] = { k, k, k, 10939058860032000ull };
+		const uint64_t va = 13591409 + 545140134 * k;
+		p = DataType(1);
+		q = DataType(1);
+		if (k)
+		{
+			p = Product<DataType>(vp, 3);
+			q = Product<DataType>(vq, 4);
+		}
+		a = Product<DataType>(&va, 1);
+		pNeg = k != 0;
+	};
+	SplitSums<DataType> s;
+	BinarySplit(0, terms, term, s, false);
+	/*pi = 426880 sqrt(10005) Q / T*/
+	BigNum<DataType, 0> x = PowerOfTen<DataType>(d);
+	x.Square();
+	x *= uint64_t(10005);
+	x = ISqrt(x);
+	x *= uint64_t(426880);
+	return DropGuardDigits(TruncatedQuotient(s.q, s.t, x, d),
+		ConstantGuardDigits);
+}
+/**Find e with the series of 1 / k!, summed with binary splitting.
+\param digits The amount of digits after the decimal point.
+\return floor(e 10^digits).*/
+template<typename DataType>
+BigNum<DataType, 0> E(const std::size_t digits)
+{
+	const std::size_t d = digits + ConstantGuardDigits;
+	/*Stop once k! is past 10^d.*/
+	uint64_t terms = 1;
+	for (double lg = 0.0; lg < double(d) + 1.0; ++terms)
+		lg += std::log10(double(terms));
+	auto term = [](const uint64_t k, BigNum<DataType, 0>& p, bool& pNeg,
+		BigNum<DataType, 0>& q, BigNum<DataType, 0>& a)
+	{
+		p = DataType(1);
+		pNeg = false;
+		q = DataType(1);
+		if (k)
+			q = Product<DataType>(&k, 1);
+		a = DataType(1);
+	};
+	SplitSums<DataType> s;
+	BinarySplit(0, terms, term, s, false);
+	return DropGuardDigits(
+		TruncatedQuotient(s.t, s.q, PowerOfTen<DataType>(d), d),
+		ConstantGuardDigits);
+}
+/**Find atanh(1 / x) 10^digits with binary splitting, from
+atanh(1 / x) = sum 1 / ((2k + 1) x^(2k + 1)).
+\param x The inverse of the argument.  Must be 2 or more.
+\param digits The amount of digits after the decimal point.
+\return About atanh(1 / x) 10^digits, off by at most 2.*/
+template<typename DataType>
+BigNum<DataType, 0> InverseAtanh(const uint64_t x, const std::size_t digits)
+{
+	const uint64_t terms = uint64_t(double(digits)
+		/ (2.0 * std::log10(double(x)))) + 2;
+	/*p(k) = 2k - 1, q(k) = (2k + 1) x^2 and q(0) = x*/
+	auto term = [x](const uint64_t k, BigNum<DataType, 0>& p, bool& pNeg,
+		BigNum<DataType, 0>& q, BigNum<DataType, 0>& a)
+	{
+		const uint64_t vp = 2 * k - 1;
+		const uint64_t vq[3] = { 2 * k + 1, x, x };
+		p = DataType(1);
+		q = Product<DataType>(vq + 1, 1);
+		if (k)
+		{
+			p = Product<DataType>(&vp, 1);
+			q = Product<DataType>(vq, 3);
+		}
+		pNeg = false;
+		a = DataType(1);
+	};
+	SplitSums<DataType> s;
+	BinarySplit(0, terms, term, s, false);
+	return TruncatedQuotient(s.t, s.q, PowerOfTen<DataType>(digits), digits);
+}
+/**Find log 2 from
+log 2 = 18 atanh(1 / 26) - 2 atanh(1 / 4801) + 8 atanh(1 / 8749).
+Each series is summed with binary splitting.
+\param digits The amount of digits after the decimal point.
+\return floor(log(2) 10^digits).*/
+template<typename DataType>
+BigNum<DataType, 0> Log2(const std::size_t digits)
+{
+	const std::size_t d = digits + ConstantGuardDigits;
+	BigNum<DataType, 0> x = InverseAtanh<DataType>(26, d);
+	x *= uint64_t(18);
+	BigNum<DataType, 0> y = InverseAtanh<DataType>(8749, d);
+	y *= uint64_t(8);
+	x += y;
+	y = InverseAtanh<DataType>(4801, d);
+	y *= uint64_t(2);
+	x -= y;
+	return DropGuardDigits(x, ConstantGuardDigits);
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "CpuFeatures.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CG_CPUID
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CG_CPUID
+#endif
+
+namespace cg {
+
+#if defined(CG_CPUID)
+namespace {
+
+/**Run cpuid.
+\param leaf The leaf (eax).
+\param sub The sub leaf (ecx).
+\param regs [out] eax, ebx, ecx and edx.*/
+void CpuId(const unsigned int leaf, const unsigned int sub,
+	unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuidex(r, int(leaf), int(sub));
+	for (int i = 0; i < 4; ++i)
+		regs[i] = (unsigned int)r[i];
+#else
+	__cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+/**Read the extended control register 0, which says which register states
+the OS saves.  Only valid when cpuid says the OS uses xsave.
+\return XCR0.*/
+unsigned long long XGetBV()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int lo;
+	unsigned int hi;
+	__asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return (unsigned long long)hi << 32 | lo;
+#endif
+}
+
+}
+#endif
+
+CpuFeatures CpuFeatures::Detect()
+{
+	CpuFeatures f;
+#if defined(CG_CPUID)
+	unsigned int r[4];
+	CpuId(0, 0, r);
+	if (r[0] < 7)
+		return f;
+	CpuId(1, 0, r);
+	const bool osxsave = (r[2] >> 27) & 1;
+	const bool avx = (r[2] >> 28) & 1;
+	CpuId(7, 0, r);
+	f.BMI2 = (r[1] >> 8) & 1;
+	f.ADX = (r[1] >> 19) & 1;
+	if (osxsave && avx)
+	{
+		const unsigned long long xcr0 = XGetBV();
+		/*The xmm and ymm state, then the opmask and both halves of the zmm
+		state.*/
+		if ((xcr0 & 0x6) == 0x6)
+		{
+			f.AVX2 = (r[1] >> 5) & 1;
+			if ((xcr0 & 0xe6) == 0xe6)
+				f.AVX512F = (r[1] >> 16) & 1;
+		}
+	}
+#endif
+	return f;
+}
+const CpuFeatures& CpuFeatures::Get()
+{
+	static const CpuFeatures features = Detect();
+	return features;
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+namespace cg {
+
+/**The instruction set extensions of the CPU the program is running on, as
+far as the math kernels care about them.  Found once with cpuid, see Get.*/
+class CpuFeatures {
+public:
+	/**The mulx instruction, a product that leaves the flags alone.*/
+	bool BMI2 = false;
+	/**The adcx and adox instructions, two independent carry chains.*/
+	bool ADX = false;
+	/**256 bit integer vectors, with the OS saving their state.*/
+	bool AVX2 = false;
+	/**512 bit vectors (the foundation set), with the OS saving their
+	state.*/
+	bool AVX512F = false;
+	/**Get the features of this CPU.  They are found on the first call.
+	\return The features.*/
+	static const CpuFeatures& Get();
+	/**Find the features of this CPU with cpuid.  All false on other
+	architectures.
+	\return The features.*/
+	static CpuFeatures Detect();
+};
+
+}
@@ -0,0 +1,215 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include "BigNum.hpp"
+
+namespace cg {
+
+/**Find a pair of Fibonacci numbers by fast doubling.  Each bit of n takes two
+squares:  F(2k+1) = 4 F(k)^2 - F(k-1)^2 + 2 (-1)^k,
+F(2k-1) = F(k)^2 + F(k-1)^2 and F(2k) = F(2k+1) - F(2k-1).
+\param n The index.  Must not be zero.
+\param f [out] F(n).
+\param g [out] F(n-1).*/
+template<typename DataType, std::size_t Units>
+void FibonacciPair(const uint64_t n, BigNum<DataType, Units>& f,
+	BigNum<DataType, Units>& g)
+{
+	f = DataType(1);
+	g = DataType(0);
+	std::size_t bit = 63;
+	while (!((n >> bit) & 1))
+		--bit;
+	bool odd = true;
+	while (bit--)
+	{
+		BigNum<DataType, Units> a = f;
+		BigNum<DataType, Units> b = g;
+		a.Square();
+		b.Square();
+		/*up = F(2k+1), down = F(2k-1)*/
+		BigNum<DataType, Units> up = a;
+		up += a;
+		up += up;
+		if (odd)
+			up -= DataType(2);
+		else
+			up += DataType(2);
+		up -= b;
+		a += b;
+		if ((n >> bit) & 1)
+		{
+			f = up;
+			up -= a;
+			g = up;
+		}
+		else
+		{
+			up -= a;
+			f = up;
+			g = a;
+		}
+		odd = ((n >> bit) & 1) != 0;
+	}
+}
+/**Find a Fibonacci number by fast doubling (see FibonacciPair).
+\param n The index.
+\return F(n).*/
+template<typename DataType, std::size_t Units = 0>
+BigNum<DataType, Units> Fibonacci(const uint64_t n)
+{
+	BigNum<DataType, Units> f;
+	BigNum<DataType, Units> g;
+	if (n == 0)
+	{
+		f = DataType(0);
+		return f;
+	}
+	FibonacciPair(n, f, g);
+	return f;
+}
+/**Find a Lucas number, L(n) = F(n) + 2 F(n-1) (see FibonacciPair).
+\param n The index.
+\return L(n).*/
+template<typename DataType, std::size_t Units = 0>
+BigNum<DataType, Units> Lucas(const uint64_t n)
+{
+	BigNum<DataType, Units> f;
+	BigNum<DataType, Units> g;
+	if (n == 0)
+	{
+		f = DataType(2);
+		return f;
+	}
+	FibonacciPair(n, f, g);
+	f += g;
+	f += g;
+	return f;
+}
+/**Multiply two 2x2 matrices of numbers.
+\param a The first matrix, row by row.
+\param b The second matrix, row by row.
+\param r [out] a b, row by row.  Must not be a or b.*/
+template<typename DataType, std::size_t Units>
+void MatrixMul(const BigNum<DataType, Units>* a,
+	const BigNum<DataType, Units>* b, BigNum<DataType, Units>* r)
+{
+	for (std::size_t i = 0; i < 4; i += 2)
+	{
+		for (std::size_t j = 0; j < 2; ++j)
+		{
+			BigNum<DataType, Units> t = a[i + 1];
+			r[i + j] = a[i];
+			r[i + j] *= b[j];
+			t *= b[2 + j];
+			r[i + j] += t;
+		}
+	}
+}
+/**Square a 2x2 matrix of numbers.  Takes two squares and three
+multiplications instead of eight multiplications:
+[a b; c d]^2 = [a^2 + b c, b (a + d); c (a + d), d^2 + b c].
+\param a The matrix, row by row.
+\param r [out] a^2, row by row.  Must not be a.*/
+template<typename DataType, std::size_t Units>
+void MatrixSquare(const BigNum<DataType, Units>* a,
+	BigNum<DataType, Units>* r)
+{
+	BigNum<DataType, Units> bc = a[1];
+	bc *= a[2];
+	BigNum<DataType, Units> ad = a[0];
+	ad += a[3];
+	r[0] = a[0];
+	r[0].Square();
+	r[0] += bc;
+	r[1] = a[1];
+	r[1] *= ad;
+	r[2] = a[2];
+	r[2] *= ad;
+	r[3] = a[3];
+	r[3].Square();
+	r[3] += bc;
+}
+/**Raise a 2x2 matrix of numbers to a power by squaring.
+\param m The matrix, row by row.
+\param n The power.
+\param r [out] m^n, row by row.  Must not be m.*/
+template<typename DataType, std::size_t Units>
+void MatrixPow(const BigNum<DataType, Units>* m, const uint64_t n,
+	BigNum<DataType, Units>* r)
+{
+	BigNum<DataType, Units> t[4];
+	r[0] = DataType(1);
+	r[1] = DataType(0);
+	r[2] = DataType(0);
+	r[3] = DataType(1);
+	if (n == 0)
+		return;
+	std::size_t bit = 63;
+	while (!((n >> bit) & 1))
+		--bit;
+	for (std::size_t i = 0; i < 4; ++i)
+		r[i] = m[i];
+	while (bit--)
+	{
+		MatrixSquare(r, t);
+		if ((n >> bit) & 1)
+			MatrixMul(t, m, r);
+		else
+			for (std::size_t i = 0; i < 4; ++i)
+				r[i] = t[i];
+	}
+}
+/**Find a term of the linear recurrence x(k+1) = p x(k) + q x(k-1) with the
+matrix power [p q; 1 0]^(n-1).
+\param p The first coefficient.
+\param q The second coefficient.
+\param x0 x(0).
+\param x1 x(1).
+\param n The index.
+\return x(n).*/
+template<typename DataType, std::size_t Units>
+BigNum<DataType, Units> LinearRecurrence(const BigNum<DataType, Units>& p,
+	const BigNum<DataType, Units>& q, const BigNum<DataType, Units>& x0,
+	const BigNum<DataType, Units>& x1, const uint64_t n)
+{
+	if (n == 0)
+		return x0;
+	BigNum<DataType, Units> m[4] = { p, q, BigNum<DataType, Units>(),
+		BigNum<DataType, Units>() };
+	m[2] = DataType(1);
+	m[3] = DataType(0);
+	BigNum<DataType, Units> r[4];
+	MatrixPow(m, n - 1, r);
+	BigNum<DataType, Units> x = r[0];
+	x *= x1;
+	r[1] *= x0;
+	x += r[1];
+	return x;
+}
+
+}
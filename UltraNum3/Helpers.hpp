@@ -145,23 +145,99 @@ T GCD(T first, T second)
 	return 1;
 }
 
+template<typename DataType, std::size_t Units>
+class BigNum;
+template<typename T>
+inline std::size_t GCDArray(T* a, std::size_t na, T* b, std::size_t nb);
+template<typename T>
+inline std::size_t ExtGCDArray(const T* a, std::size_t na, const T* b,
+	std::size_t nb, T* g, T* x, T* y);
+
+/**Find the GCD of two big numbers.  Works on the digits directly with the
+binary GCD or Lehmer's algorithm (see cg::GCDArray), never dividing by the
+whole number.
+\param first The first number.
+\param second The second number.
+\return The GCD.*/
+template<typename DataType, std::size_t Units>
+BigNum<DataType, Units> GCD(BigNum<DataType, Units> first,
+	BigNum<DataType, Units> second)
+{
+	if (first.RealSize() < second.RealSize())
+	{
+		GCDArray(second.Begin(), second.Size(), first.Begin(), first.Size());
+		return second;
+	}
+	GCDArray(first.Begin(), first.Size(), second.Begin(), second.Size());
+	return first;
+}
+
+/**Find the GCD of two big numbers and the cofactors that make it, so that
+a x - b y = g with 1 <= x <= b / g and 0 <= y < a / g (see
+cg::ExtGCDArray).
+\param a The first number.  Must not be zero.
+\param b The second number.
+\param x [out] The cofactor of a, or nullptr.
+\param y [out] The cofactor of b, or nullptr.
+\return The GCD.*/
+template<typename DataType, std::size_t Units>
+BigNum<DataType, Units> ExtGCD(const BigNum<DataType, Units>& a,
+	const BigNum<DataType, Units>& b, BigNum<DataType, Units>* x,
+	BigNum<DataType, Units>* y)
+{
+	const std::size_t na = a.RealSize();
+	const std::size_t nb = b.RealSize();
+	const std::size_t n = na > nb ? na : nb;
+	BigNum<DataType, Units> g;
+	BigNum<DataType, Units> cx;
+	g.ExpandTo(n);
+	cx.ExpandTo(n);
+	if (y)
+		y->ExpandTo(n);
+	if (g.Size() < n || cx.Size() < n || (y && y->Size() < n))
+		throw std::invalid_argument("Number is too small for the cofactors.");
+	ExtGCDArray(a.Begin(), na, b.Begin(), nb, g.Begin(), cx.Begin(),
+		y ? y->Begin() : (DataType*)nullptr);
+	if (x)
+		*x = cx;
+	return g;
+}
+/**Find the inverse of a number modulo another.
+\param a The number.  Must not be zero.
+\param m The modulus.
+\return x such that a x = 1 mod m.
+\throws Throws invalid_argument if a and m share a factor.*/
+template<typename DataType, std::size_t Units>
+BigNum<DataType, Units> ModInverse(const BigNum<DataType, Units>& a,
+	const BigNum<DataType, Units>& m)
+{
+	BigNum<DataType, Units> x;
+	const BigNum<DataType, Units> g = ExtGCD(a, m, &x,
+		(BigNum<DataType, Units>*)nullptr);
+	if (g.RealSize() != 1 || g.Begin()[0] != 1)
+		throw std::invalid_argument("The number has no inverse.");
+	/*x = m only when m is 1.*/
+	if (m.RealSize() == 1 && m.Begin()[0] == 1)
+		x = DataType(0);
+	return x;
+}
+
 /**Get the least common multiple of a pair of numbers.
 \param first The first number.
 \param second The second number.
-\return The number that is the least common multiple.*/
+\return The numbers that multiply the first and the second number into
+their least common multiple, see LCMPair.*/
 template<typename T>
-T LCM(const T& first, const T& second)
+LCMPair<T> LCM(const T& first, const T& second)
 {
-	LCMPair lcmresult;
-	T gcd = GCD<T>(first, second);
+	LCMPair<T> lcmresult;
+	T gcd = GCD(first, second);
+	lcmresult.first = second;
+	lcmresult.second = first;
 	if (gcd == 1)
-	{
-		lcmresult.first = second;
-		lcmresult.second = first;
 		return lcmresult;
-	}
-	lcmresult.first = (second / gcd);
-	lcmresult.second = (first / gcd);
+	lcmresult.first /= gcd;
+	lcmresult.second /= gcd;
 	return lcmresult;
 }
 
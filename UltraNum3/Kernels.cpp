@@ -0,0 +1,231 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Kernels.hpp"
+#include "BasicMathFuncs.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CG_KERNELS_ADX
+#define CG_KERNELS_ADX_ASM
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#define CG_KERNELS_ADX
+#endif
+
+namespace cg {
+
+namespace {
+
+#if defined(CG_KERNELS_ADX)
+/**AddMulArray with mulx, adcx and adox: the carries of the products and of
+the sums are kept in the two flags, so the chains do not wait on each other.
+Only call on a CPU with BMI2 and ADX.*/
+uint64_t AddMulArray_ADX(uint64_t* r, const uint64_t* a, std::size_t n,
+	uint64_t m)
+{
+	/*The odd units first, so the loop only does blocks of 4.*/
+	const std::size_t lead = n % 4;
+	uint64_t c = AddMulArray<uint64_t>(r, a, lead, m);
+	std::size_t q = n / 4;
+	if (q == 0)
+		return c;
+	r += lead;
+	a += lead;
+#if defined(CG_KERNELS_ADX_ASM)
+	uint64_t t;
+	uint64_t l0;
+	uint64_t h0;
+	uint64_t l1;
+	uint64_t h1;
+	/*Carry (CF) joins the products, overflow (OF) adds them to r.  Zeroing t
+	clears both flags.  Adding t folds them into c at the end of each block,
+	which cannot overflow and leaves both clear again, as dec changes OF.*/
+	__asm__(
+		"xorl %k[t], %k[t]\n\t"
+		"1:\n\t"
+		"mulx (%[a]), %[l0], %[h0]\n\t"
+		"adcx %[c], %[l0]\n\t"
+		"adox (%[r]), %[l0]\n\t"
+		"mov %[l0], (%[r])\n\t"
+		"mulx 8(%[a]), %[l1], %[h1]\n\t"
+		"adcx %[h0], %[l1]\n\t"
+		"adox 8(%[r]), %[l1]\n\t"
+		"mov %[l1], 8(%[r])\n\t"
+		"mulx 16(%[a]), %[l0], %[h0]\n\t"
+		"adcx %[h1], %[l0]\n\t"
+		"adox 16(%[r]), %[l0]\n\t"
+		"mov %[l0], 16(%[r])\n\t"
+		"mulx 24(%[a]), %[l1], %[c]\n\t"
+		"adcx %[h0], %[l1]\n\t"
+		"adox 24(%[r]), %[l1]\n\t"
+		"mov %[l1], 24(%[r])\n\t"
+		"adcx %[t], %[c]\n\t"
+		"adox %[t], %[c]\n\t"
+		"lea 32(%[a]), %[a]\n\t"
+		"lea 32(%[r]), %[r]\n\t"
+		"dec %[q]\n\t"
+		"jnz 1b\n\t"
+		: [a]"+r"(a), [r]"+r"(r), [q]"+r"(q), [c]"+r"(c), [t]"=&r"(t),
+		[l0]"=&r"(l0), [h0]"=&r"(h0), [l1]"=&r"(l1), [h1]"=&r"(h1)
+		: "d"(m)
+		: "cc", "memory");
+#else
+	unsigned char cf = 0;
+	unsigned char of = 0;
+	unsigned long long hi;
+	unsigned long long lo;
+	for (std::size_t i = 0; i < q * 4; ++i)
+	{
+		lo = _mulx_u64(a[i], m, &hi);
+		cf = _addcarryx_u64(cf, lo, c, &lo);
+		of = _addcarryx_u64(of, lo, r[i], &lo);
+		r[i] = lo;
+		c = hi;
+	}
+	c += cf;
+	c += of;
+#endif
+	return c;
+}
+/**SubMulArray with mulx, adcx and adox.  r - p - b is found as
+~(~r + p + b), so the borrows can ride the overflow chain too.  Only call
+on a CPU with BMI2 and ADX.*/
+uint64_t SubMulArray_ADX(uint64_t* r, const uint64_t* a, std::size_t n,
+	uint64_t m)
+{
+	const std::size_t lead = n % 4;
+	uint64_t c = SubMulArray<uint64_t>(r, a, lead, m);
+	std::size_t q = n / 4;
+	if (q == 0)
+		return c;
+	r += lead;
+	a += lead;
+#if defined(CG_KERNELS_ADX_ASM)
+	uint64_t t;
+	uint64_t x;
+	uint64_t l0;
+	uint64_t h0;
+	uint64_t l1;
+	uint64_t h1;
+	/*not leaves the flags alone.*/
+	__asm__(
+		"xorl %k[t], %k[t]\n\t"
+		"1:\n\t"
+		"mulx (%[a]), %[l0], %[h0]\n\t"
+		"adcx %[c], %[l0]\n\t"
+		"mov (%[r]), %[x]\n\t"
+		"not %[x]\n\t"
+		"adox %[l0], %[x]\n\t"
+		"not %[x]\n\t"
+		"mov %[x], (%[r])\n\t"
+		"mulx 8(%[a]), %[l1], %[h1]\n\t"
+		"adcx %[h0], %[l1]\n\t"
+		"mov 8(%[r]), %[x]\n\t"
+		"not %[x]\n\t"
+		"adox %[l1], %[x]\n\t"
+		"not %[x]\n\t"
+		"mov %[x], 8(%[r])\n\t"
+		"mulx 16(%[a]), %[l0], %[h0]\n\t"
+		"adcx %[h1], %[l0]\n\t"
+		"mov 16(%[r]), %[x]\n\t"
+		"not %[x]\n\t"
+		"adox %[l0], %[x]\n\t"
+		"not %[x]\n\t"
+		"mov %[x], 16(%[r])\n\t"
+		"mulx 24(%[a]), %[l1], %[c]\n\t"
+		"adcx %[h0], %[l1]\n\t"
+		"mov 24(%[r]), %[x]\n\t"
+		"not %[x]\n\t"
+		"adox %[l1], %[x]\n\t"
+		"not %[x]\n\t"
+		"mov %[x], 24(%[r])\n\t"
+		"adcx %[t], %[c]\n\t"
+		"adox %[t], %[c]\n\t"
+		"lea 32(%[a]), %[a]\n\t"
+		"lea 32(%[r]), %[r]\n\t"
+		"dec %[q]\n\t"
+		"jnz 1b\n\t"
+		: [a]"+r"(a), [r]"+r"(r), [q]"+r"(q), [c]"+r"(c), [t]"=&r"(t),
+		[x]"=&r"(x), [l0]"=&r"(l0), [h0]"=&r"(h0), [l1]"=&r"(l1),
+		[h1]"=&r"(h1)
+		: "d"(m)
+		: "cc", "memory");
+#else
+	unsigned char cf = 0;
+	unsigned char of = 0;
+	unsigned long long hi;
+	unsigned long long lo;
+	unsigned long long x;
+	for (std::size_t i = 0; i < q * 4; ++i)
+	{
+		lo = _mulx_u64(a[i], m, &hi);
+		cf = _addcarryx_u64(cf, lo, c, &lo);
+		of = _addcarryx_u64(of, ~r[i], lo, &x);
+		r[i] = ~x;
+		c = hi;
+	}
+	c += cf;
+	c += of;
+#endif
+	return c;
+}
+#endif
+
+/**Bind the kernels on the first call, then do it.*/
+uint64_t AddMulFirst(uint64_t* r, const uint64_t* a, std::size_t n,
+	uint64_t m)
+{
+	Kernels::Bind(CpuFeatures::Get());
+	return Kernels::AddMul(r, a, n, m);
+}
+/**Bind the kernels on the first call, then do it.*/
+uint64_t SubMulFirst(uint64_t* r, const uint64_t* a, std::size_t n,
+	uint64_t m)
+{
+	Kernels::Bind(CpuFeatures::Get());
+	return Kernels::SubMul(r, a, n, m);
+}
+/**Bind the kernels before main, so threads started later only read the
+pointers.  Calls from other static initializers that run first go through
+AddMulFirst and SubMulFirst.*/
+const bool bound = (Kernels::Bind(CpuFeatures::Get()), true);
+
+}
+
+Kernels::MulAccPtr Kernels::AddMul = &AddMulFirst;
+Kernels::MulAccPtr Kernels::SubMul = &SubMulFirst;
+
+void Kernels::Bind(const CpuFeatures& f)
+{
+	AddMul = &AddMulArray<uint64_t>;
+	SubMul = &SubMulArray<uint64_t>;
+#if defined(CG_KERNELS_ADX)
+	if (f.BMI2 && f.ADX)
+	{
+		AddMul = &AddMulArray_ADX;
+		SubMul = &SubMulArray_ADX;
+	}
+#else
+	(void)f;
+#endif
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CpuFeatures.hpp"
+
+namespace cg {
+
+/**The unit kernels that have versions for particular instruction sets.  Each
+is called through a pointer that is bound to the best version for the CPU
+the program runs on, once, before it is first used.  The generic versions
+are the templates in BasicMathFuncs.hpp.*/
+class Kernels {
+public:
+	/**An array times a unit added to or subtracted from another array, see
+	AddMulArray and SubMulArray.*/
+	using MulAccPtr = uint64_t(*)(uint64_t*, const uint64_t*, std::size_t,
+		uint64_t);
+	/**Add an array times a unit to another array, see AddMulArray.*/
+	static MulAccPtr AddMul;
+	/**Subtract an array times a unit from another array, see SubMulArray.*/
+	static MulAccPtr SubMul;
+	/**Bind the kernels for a set of features.  May be called again, for
+	instance to test or time the generic kernels, but not while another
+	thread is using them.
+	\param f The features to use.  Kernels for features not in f are not
+	used.*/
+	static void Bind(const CpuFeatures& f);
+};
+
+}
@@ -156,6 +156,14 @@ protected:
 	{
 		return ((const DataType*)(m_data + (i * sizeof(T))));
 	}
+	/**Make sure the storage can hold X amount of elements.
+	\param amt The amount to hold.
+	\throws Throws runtime_error if amt is more than the fixed size.*/
+	void ExpandTo(std::size_t amt)
+	{
+		if (amt > SizeP)
+			throw std::runtime_error("The list is full.");
+	}
 	/**Stop copying*/
 	Storage(const SelfType&) = delete;
 	/**Stop copying*/
@@ -187,22 +195,22 @@ public:
 	using T = typename DataType;
 	/**The type of this object.*/
 	using SelfType = typename Storage<T, 0>;
-	/**The amount to expand when re allocating.*/
+	/**The least amount to expand when re allocating.  Past this the capacity
+	is doubled so that pushing many elements stays linear.*/
 	const static std::size_t ExpandAmount = 8;
 	/**default ctor
 	\param cap The initial capacity.*/
-	Storage(std::size_t cap = 0) :m_cap(8), m_size(0)
+	Storage(std::size_t cap = 0) :m_data(nullptr), m_cap(0), m_size(0)
 	{
-		if (cap != 0)
-			m_data = (DataType*)std::malloc(m_cap * sizeof(DataType));
-		else
-			m_data = nullptr;
+		ExpandTo(cap);
 	};
 	/**Create with an array of things.
 	\param arr The array to add.
 	\param aSize The size of the array.*/
 	Storage(const DataType* arr, std::size_t aSize)
+		:m_data(nullptr), m_cap(0), m_size(0)
 	{
+		ExpandTo(aSize);
 		auto end = arr + aSize;
 		for (std::size_t i = 0; arr != end; ++arr)
 			Emplace(i++, *arr);
@@ -224,6 +232,7 @@ public:
 
 	\param vals The values to insert.*/
 	Storage(std::initializer_list<DataType>&& vals)
+		:m_data(nullptr), m_cap(0), m_size(0)
 	{
 		std::size_t sz = vals.size();
 		ExpandTo(sz);
@@ -236,6 +245,8 @@ public:
 	\param other The thing to move.*/
 	void operator=(SelfType&& other)
 	{
+		if (m_data)
+			std::free(m_data);
 		m_data = other.m_data;
 		other.m_data = nullptr;
 		m_size = other.m_size;
@@ -245,7 +256,7 @@ public:
 	virtual ~Storage()
 	{
 		if (m_data)
-			delete[] m_data;
+			std::free(m_data);
 	}
 	/**Determine if another element can be inserted.
 	\return True if an insert now would NOT throw an exception.*/
@@ -263,7 +274,7 @@ public:
 		if (i > m_size)
 			throw std::runtime_error("Index out of bounds.");
 		if (m_size == m_cap)
-			ExpandTo(m_cap + ExpandAmount);
+			ExpandTo(m_cap + (m_cap > ExpandAmount ? m_cap : ExpandAmount));
 		if (m_size != i)
 			std::memmove(Addr() + i + 1, Addr() + i,
 				sizeof(U)*(m_size - i));
@@ -279,7 +290,7 @@ public:
 		if (i > m_size)
 			throw std::runtime_error("Index out of bounds.");
 		if (m_size == m_cap)
-			ExpandTo(m_cap + ExpandAmount);
+			ExpandTo(m_cap + (m_cap > ExpandAmount ? m_cap : ExpandAmount));
 		if (m_size != i)
 			std::memmove(Addr() + i + 1, Addr() + i,
 				sizeof(T)*(m_size - i));
@@ -309,6 +320,7 @@ protected:
 		{
 			/**Dont initialize...*/
 			m_data = (T*)std::malloc(sizeof(T)*amt);
+			m_cap = amt;
 			return;
 		}
 		/**Dont initialize...*/
@@ -316,7 +328,7 @@ protected:
 		std::memmove(nData, Addr(), sizeof(T) * m_size);
 		m_cap = amt;
 
-		delete m_data;
+		std::free(m_data);
 		m_data = nData;
 	}
 	/**Get the address of the data.
@@ -410,6 +422,15 @@ public:
 	{
 		return m_size;
 	}
+	/**Make sure the list can hold an amount of elements without allocating
+	again.
+	\param amt The amount of elements to make room for.
+	\throws Throws runtime_error if amt is more than a fixed size list can
+	hold.*/
+	void Reserve(std::size_t amt)
+	{
+		ExpandTo(amt);
+	}
 	/**Push an object to the back of the list.
 	\param o The object.*/
 	template<typename U>
@@ -559,7 +580,7 @@ public:
 	SelfType Copy() const
 	{
 		SelfType copy;
-		copy.m_cap = m_cap;
+		copy.ExpandTo(m_size);
 		copy.m_size = m_size;
 		std::memcpy(copy.Addr(), Addr(), m_size * sizeof(T));
 		return copy;
@@ -0,0 +1,338 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include "BigNum.hpp"
+#include "BasicMathFuncs.hpp"
+
+namespace cg {
+
+/**Find the negative inverse of an odd unit, as used by Montgomery reduction.
+Each Newton step doubles the correct low bits.
+\param m0 The unit.  Must be odd.
+\return -1/m0 mod B.*/
+template<typename T>
+inline T MontInverseUnit(const T m0)
+{
+	/*m0 * m0 = 1 mod 8 for any odd m0, so 3 bits start correct.*/
+	T x = m0;
+	T hi;
+	for (std::size_t bits = 3; bits < sizeof(T) * 8; bits *= 2)
+		x = MulUnit(x, T(T(2) - MulUnit(m0, x, hi)), hi);
+	return T(T(0) - x);
+}
+/**Montgomery multiplication with the coarsely integrated operand scanning
+(CIOS) method.  Each row of the product and its reduction are added with
+AddMulArray, and the running total slides up one unit per row so it never
+takes more than n + 2 units.
+\param r [out] a * b / B^n mod m.  Must have room for n + n + 2 units and
+must not overlap a, b or m.  The result is in the first n units.
+\param a The first array, less than m.
+\param b The second array, less than m.
+\param m The modulus.  Must be odd.
+\param n The size of a, b and m.
+\param inv -1/m mod B, see MontInverseUnit.*/
+template<typename T>
+inline void MontMulArray(T* r, const T* a, const T* b, const T* m,
+	const std::size_t n, const T inv)
+{
+	ZeroOut(r, n + n + 2);
+	T hi;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		/*w = w + a * b[i] + q * m, with q chosen so the low unit is zero.
+		The next row starts one unit up, which divides by B.*/
+		T* w = r + i;
+		unsigned char c = AddCarry<T>(0, w[n],
+			AddMulArray(w, a, n, b[i]), w[n]);
+		w[n + 1] = T(w[n + 1] + c);
+		c = AddCarry<T>(0, w[n],
+			AddMulArray(w, m, n, MulUnit(w[0], inv, hi)), w[n]);
+		w[n + 1] = T(w[n + 1] + c);
+	}
+	T* t = r + n;
+	if (CompareArray(t, RealSize(t, n + 1), m, n) != -1)
+		SubArray(t, n + 1, m, n);
+	std::memmove(r, t, n * sizeof(T));
+}
+
+/**Multiply numbers modulo a fixed odd modulus without dividing (Montgomery
+multiplication).  Numbers are kept in the form x * B^n mod m, see
+MontgomeryInt.
+\tparam DataType The type of the digits.
+\tparam Units The amount of digits of the number type.*/
+template<typename DataType, std::size_t Units>
+class MontgomeryReducer
+{
+public:
+	/**A self reference type.*/
+	using Self = MontgomeryReducer<DataType, Units>;
+	/**The number type.*/
+	using Num = BigNum<DataType, Units>;
+	/**Create a reducer.
+	\param m The modulus.  Must be odd.*/
+	MontgomeryReducer(const Num& m)
+		:m_size(m.RealSize())
+	{
+		if (m_size == 0 || (m.Begin()[0] & 1) == 0)
+			throw std::invalid_argument("Modulus must be odd.");
+		const std::size_t n = m_size;
+		m_data = new DataType[3 * n + 2 * (n + n + 1)];
+		m_r2 = m_data + n;
+		m_one = m_r2 + n;
+		m_work = m_one + n;
+		std::memcpy(m_data, m.Begin(), n * sizeof(DataType));
+		m_inv = MontInverseUnit(m_data[0]);
+		/*B^(2n) mod m converts into the Montgomery form.*/
+		DataType* t = m_work + n + n + 1;
+		ZeroOut(m_work, n + n + 1);
+		ZeroOut(t, n + n + 1);
+		t[n + n] = 1;
+		DivArray_Knuth(t, n + n + 1, m_data, n, m_work);
+		std::memcpy(m_r2, m_work, n * sizeof(DataType));
+		ZeroOut(m_one, n);
+		m_one[0] = 1;
+	}
+	/**Reducers own their buffers and are not copied.*/
+	MontgomeryReducer(const Self&) = delete;
+	/**Reducers own their buffers and are not copied.*/
+	void operator=(const Self&) = delete;
+	/**Free the buffers.*/
+	~MontgomeryReducer()
+	{
+		delete[] m_data;
+	}
+	/**Multiply two numbers in the Montgomery form.  Works in the reducer's
+	own space, so each thread needs its own reducer.
+	\param r [out] The product, Size() digits.  May overlap a or b.
+	\param a The first number, Size() digits.
+	\param b The second number, Size() digits.*/
+	void Mul(DataType* r, const DataType* a, const DataType* b)
+	{
+		MontMulArray(m_work, a, b, m_data, m_size, m_inv);
+		std::memcpy(r, m_work, m_size * sizeof(DataType));
+	}
+	/**Convert a number into the Montgomery form.
+	\param r [out] The converted number.  Will have at least Size() digits.
+	\param a The number.  Is reduced first when not less than the modulus.*/
+	template<std::size_t S>
+	void ToMont(Num& r, const BigNum<DataType, S>& a)
+	{
+		const std::size_t n = m_size;
+		const std::size_t sa = a.RealSize();
+		r.ExpandTo(n);
+		if (r.Size() < n)
+			throw std::invalid_argument("Number is too small for the modulus.");
+		ZeroOut(r.Begin(), r.Size());
+		if (CompareArray(a.Begin(), sa, m_data, n) == -1)
+			std::memcpy(r.Begin(), a.Begin(), sa * sizeof(DataType));
+		else
+		{
+			DataType* q = new DataType[sa + sa + 2];
+			DataType* rem = q + sa + 1;
+			DivMod(a.Begin(), sa, m_data, n, q, rem);
+			std::memcpy(r.Begin(), rem, n * sizeof(DataType));
+			delete[] q;
+		}
+		Mul(r.Begin(), r.Begin(), m_r2);
+	}
+	/**Convert a number out of the Montgomery form.
+	\param r [out] The converted number.  Will have at least Size() digits.
+	\param a The number in the Montgomery form, Size() digits.*/
+	void FromMont(Num& r, const DataType* a)
+	{
+		r.ExpandTo(m_size);
+		if (r.Size() < m_size)
+			throw std::invalid_argument("Number is too small for the modulus.");
+		ZeroOut(r.Begin(), r.Size());
+		Mul(r.Begin(), a, m_one);
+	}
+	/**Get the size of the modulus.
+	\return The amount of digits in the modulus.*/
+	std::size_t Size() const
+	{
+		return m_size;
+	}
+	/**Direct access to the modulus.
+	\return A pointer to the Size() digits of the modulus.*/
+	const DataType* Modulus() const
+	{
+		return m_data;
+	}
+private:
+	/**The amount of digits in the modulus.*/
+	std::size_t m_size;
+	/**-1/m mod B.*/
+	DataType m_inv;
+	/**The modulus, followed by the other arrays.*/
+	DataType* m_data;
+	/**B^(2n) mod m.*/
+	DataType* m_r2;
+	/**The number 1, n digits.*/
+	DataType* m_one;
+	/**Space for a product, n + n + 2 digits (see MontMulArray), and 4n + 2
+	while constructing.*/
+	DataType* m_work;
+};
+
+/**A number modulo an odd modulus, kept in the Montgomery form so that
+multiplying never divides.  The reducer must outlive the number.
+\tparam DataType The type of the digits.
+\tparam Units The amount of digits of the number type.*/
+template<typename DataType, std::size_t Units>
+class MontgomeryInt
+{
+public:
+	/**A self reference type.*/
+	using Self = MontgomeryInt<DataType, Units>;
+	/**The reducer type.*/
+	using Reducer = MontgomeryReducer<DataType, Units>;
+	/**The number type.*/
+	using Num = BigNum<DataType, Units>;
+	/**Create a zero.
+	\param reducer The modulus to work in.*/
+	MontgomeryInt(Reducer& reducer)
+		:m_reducer(&reducer)
+	{
+		m_value.ExpandTo(reducer.Size());
+	}
+	/**Convert a number.
+	\param reducer The modulus to work in.
+	\param n The number.*/
+	template<std::size_t S>
+	MontgomeryInt(Reducer& reducer, const BigNum<DataType, S>& n)
+		:m_reducer(&reducer)
+	{
+		reducer.ToMont(m_value, n);
+	}
+	/**Convert back to a normal number.
+	\return The number, less than the modulus.*/
+	Num Get() const
+	{
+		Num r;
+		m_reducer->FromMont(r, m_value.Begin());
+		return r;
+	}
+	/**Direct access to the Montgomery form.
+	\return The number times B^n mod m.*/
+	const Num& Value() const
+	{
+		return m_value;
+	}
+	/**Do a math operation.
+	\param r The thing to operate on this with.
+	\return A reference to this.*/
+	Self& operator*=(const Self& r)
+	{
+		m_reducer->Mul(m_value.Begin(), m_value.Begin(), r.m_value.Begin());
+		return *this;
+	}
+	/**Do a math operation.
+	\param r The thing to operate on this with.
+	\return A reference to this.*/
+	Self& operator+=(const Self& r)
+	{
+		const std::size_t n = m_reducer->Size();
+		DataType* a = m_value.Begin();
+		const bool carry = AddArray(a, n, r.m_value.Begin(), n);
+		if (carry || CompareArray(a, RealSize(a, n), m_reducer->Modulus(), n)
+			!= -1)
+			SubArray(a, n, m_reducer->Modulus(), n);
+		return *this;
+	}
+	/**Do a math operation.
+	\param r The thing to operate on this with.
+	\return A reference to this.*/
+	Self& operator-=(const Self& r)
+	{
+		const std::size_t n = m_reducer->Size();
+		DataType* a = m_value.Begin();
+		if (SubArray(a, n, r.m_value.Begin(), n))
+			AddArray(a, n, m_reducer->Modulus(), n);
+		return *this;
+	}
+	/**Divide by two modulo the modulus.
+	\return A reference to this.*/
+	Self& Halve()
+	{
+		const std::size_t n = m_reducer->Size();
+		DataType* a = m_value.Begin();
+		/*The modulus is odd, so adding it makes an odd number even.*/
+		bool carry = false;
+		if (a[0] & 1)
+			carry = AddArray(a, n, m_reducer->Modulus(), n);
+		ShiftInsigB(a, n, 1);
+		if (carry)
+			a[n - 1] |= DataType(DataType(1) << (sizeof(DataType) * 8 - 1));
+		return *this;
+	}
+	/**Do a math operation.
+	\param r The thing to operate on this with.
+	\return The result.*/
+	Self operator*(const Self& r) const
+	{
+		Self copy = *this;
+		return copy *= r;
+	}
+	/**Do a math operation.
+	\param r The thing to operate on this with.
+	\return The result.*/
+	Self operator+(const Self& r) const
+	{
+		Self copy = *this;
+		return copy += r;
+	}
+	/**Do a math operation.
+	\param r The thing to operate on this with.
+	\return The result.*/
+	Self operator-(const Self& r) const
+	{
+		Self copy = *this;
+		return copy -= r;
+	}
+	/**Compare two numbers.
+	\param r The other number.
+	\return True if equal.*/
+	bool operator==(const Self& r) const
+	{
+		const std::size_t n = m_reducer->Size();
+		return CompareArray(m_value.Begin(), n, r.m_value.Begin(), n) == 0;
+	}
+	/**Compare two numbers.
+	\param r The other number.
+	\return True if not equal.*/
+	bool operator!=(const Self& r) const
+	{
+		return !(*this == r);
+	}
+private:
+	/**The modulus.*/
+	Reducer* m_reducer;
+	/**The number in the Montgomery form.*/
+	Num m_value;
+};
+
+}
@@ -0,0 +1,175 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+
+#include <cstddef>
+#include <cstring>
+
+#include "BigNum.hpp"
+#include "Barrett.hpp"
+#include "Montgomery.hpp"
+
+namespace cg {
+
+/**Pick the window size of a sliding window power.  Bigger windows take fewer
+multiplications but more of them up front for the table.
+\param bits The amount of bits in the exponent.
+\return The window size in bits.*/
+inline std::size_t PowModWindow(const std::size_t bits)
+{
+	if (bits > 671)
+		return 6;
+	if (bits > 239)
+		return 5;
+	if (bits > 79)
+		return 4;
+	if (bits > 23)
+		return 3;
+	return bits > 7 ? 2 : 1;
+}
+/**Raise a number to a power with a sliding window, scanning the exponent from
+the most significant bit.  Only squares and the table of odd powers are
+multiplied in.
+\param r [out] The power, n units.  Must not overlap g.
+\param g The base, n units.
+\param e The exponent.
+\param ne The size of e.
+\param n The size of r and g.
+\param one The number 1 as the multiply function sees it, n units.
+\param mul The multiply function, `mul(r, a, b)` with n units each.  r may
+overlap a or b.*/
+template<typename T, typename F>
+inline void PowModArray(T* r, const T* g, const T* e, const std::size_t ne,
+	const std::size_t n, const T* one, F mul)
+{
+	const std::size_t TBits = sizeof(T) * 8;
+	const std::size_t bits = ne ? MSBNumber(e, ne) : 0;
+	std::memcpy(r, one, n * sizeof(T));
+	if (bits == 0)
+		return;
+	const std::size_t k = PowModWindow(bits);
+	/*table[i] = g^(2i + 1)*/
+	const std::size_t entries = std::size_t(1) << (k - 1);
+	T* table = new T[(entries + 1) * n];
+	T* g2 = table + entries * n;
+	std::memcpy(table, g, n * sizeof(T));
+	if (entries > 1)
+	{
+		mul(g2, g, g);
+		for (std::size_t i = 1; i < entries; ++i)
+			mul(table + i * n, table + (i - 1) * n, g2);
+	}
+	auto bit = [&](std::size_t i)
+	{
+		return (e[i / TBits] >> (i % TBits)) & 1;
+	};
+	bool started = false;
+	std::size_t i = bits;
+	while (i)
+	{
+		if (!bit(i - 1))
+		{
+			if (started)
+				mul(r, r, r);
+			--i;
+			continue;
+		}
+		/*The longest window of at most k bits that ends in a 1.*/
+		std::size_t l = i > k ? i - k : 0;
+		while (!bit(l))
+			++l;
+		std::size_t w = 0;
+		for (std::size_t j = i; j > l; --j)
+			w = (w << 1) | bit(j - 1);
+		if (started)
+		{
+			for (std::size_t j = l; j < i; ++j)
+				mul(r, r, r);
+			mul(r, r, table + (w >> 1) * n);
+		}
+		else
+			std::memcpy(r, table + (w >> 1) * n, n * sizeof(T));
+		started = true;
+		i = l;
+	}
+	delete[] table;
+}
+/**Raise a number to a power modulo another number.  Odd moduli use
+Montgomery multiplication and even ones use Barrett reduction, so nothing
+is divided while raising.
+\param base The base.
+\param exp The exponent.
+\param mod The modulus.  Must not be zero.
+\return base^exp mod the modulus.*/
+template<typename DataType, std::size_t Units, std::size_t S1, std::size_t S2>
+inline BigNum<DataType, Units> PowMod(const BigNum<DataType, S1>& base,
+	const BigNum<DataType, S2>& exp, const BigNum<DataType, Units>& mod)
+{
+	const std::size_t n = mod.RealSize();
+	if (n == 0)
+		throw std::invalid_argument("Modulus is zero.");
+	const DataType* e = exp.Begin();
+	const std::size_t ne = exp.RealSize();
+	BigNum<DataType, Units> r;
+	r.ExpandTo(n);
+	ZeroOut(r.Begin(), r.Size());
+	if (mod.Begin()[0] & 1)
+	{
+		MontgomeryReducer<DataType, Units> reducer(mod);
+		BigNum<DataType, 0> unit;
+		const DataType d1 = 1;
+		unit.PushArray(&d1, 1);
+		BigNum<DataType, Units> g;
+		BigNum<DataType, Units> one;
+		reducer.ToMont(g, base);
+		reducer.ToMont(one, unit);
+		PowModArray(r.Begin(), g.Begin(), e, ne, n, one.Begin(),
+			[&](DataType* x, const DataType* a, const DataType* b)
+		{
+			reducer.Mul(x, a, b);
+		});
+		reducer.FromMont(g, r.Begin());
+		return g;
+	}
+	BarrettReducer<DataType, Units> reducer(mod);
+	const std::size_t sb = base.RealSize();
+	DataType* g = new DataType[(sb > n ? sb : n) + n + n + n];
+	DataType* one = g + (sb > n ? sb : n);
+	DataType* t = one + n;
+	ZeroOut(g, sb > n ? sb : n);
+	std::memcpy(g, base.Begin(), sb * sizeof(DataType));
+	reducer.Reduce(g, sb);
+	ZeroOut(one, n);
+	one[0] = 1;
+	reducer.Reduce(one, n);
+	PowModArray(r.Begin(), g, e, ne, n, one,
+		[&](DataType* x, const DataType* a, const DataType* b)
+	{
+		MulArray(t, a, n, b, n);
+		reducer.Reduce(t, n + n);
+		std::memcpy(x, t, n * sizeof(DataType));
+	});
+	delete[] g;
+	return r;
+}
+
+}
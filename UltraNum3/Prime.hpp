@@ -0,0 +1,481 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "BigNum.hpp"
+#include "Montgomery.hpp"
+#include "PowMod.hpp"
+#include "Roots.hpp"
+#include "Sieve.hpp"
+
+namespace cg {
+
+/**Get the primes below 2^12.  They are sieved on the first call.
+\param count [out] The amount of primes.
+\return The primes, smallest first.*/
+inline const uint16_t* SmallPrimes(std::size_t& count)
+{
+	struct Table
+	{
+		Table()
+			:size(0)
+		{
+			SievePrimes(0, 1 << 12, [&](const uint64_t p)
+			{
+				primes[size++] = uint16_t(p);
+			}, 1);
+		}
+		uint16_t primes[564];
+		std::size_t size;
+	};
+	static const Table table;
+	count = table.size;
+	return table.primes;
+}
+/**Trial division by the odd small primes.  The primes are grouped so the
+product of each group fits in a unit, and one pass over a number with a
+precomputed reciprocal (see ModArrayPre) tests a whole group.
+\tparam T The type of the digits.*/
+template<typename T>
+class TrialDivisor
+{
+public:
+	/**A self reference type.*/
+	using Self = TrialDivisor<T>;
+	/**Group the odd primes up to a limit.
+	\param limit The largest prime to divide by.  Primes that do not fit in a
+	unit, or are past 2^32 - 1, are left out.  The primes come from a sieve
+	(see PrimeTable).*/
+	TrialDivisor(std::size_t limit = std::size_t(1) << 12)
+		:m_size(0), m_groupCount(0)
+	{
+		const std::size_t TBits = sizeof(T) * 8;
+		const T maxT = T(~T(0));
+		if (limit > uint64_t(maxT))
+			limit = std::size_t(maxT);
+		/*The largest limit PrimeTable takes, and limit + 1 cannot wrap.*/
+		if (uint64_t(limit) > (uint64_t(1) << 32) - 1)
+			limit = std::size_t((uint64_t(1) << 32) - 1);
+		std::size_t count;
+		m_primes = PrimeTable(uint64_t(limit) + 1, count);
+		/*Skip 2, numbers are checked for being even first.*/
+		m_size = count ? count - 1 : 0;
+		if (count)
+			std::memmove(m_primes, m_primes + 1, m_size * sizeof(uint32_t));
+		m_groups = new Group[m_size + 1];
+		const uint32_t* primes = m_primes;
+		for (std::size_t i = 0; i < m_size;)
+		{
+			Group& g = m_groups[m_groupCount++];
+			T prod = T(primes[i]);
+			g.first = i++;
+			while (i < m_size && prod <= maxT / primes[i])
+				prod = T(prod * primes[i++]);
+			g.last = i;
+			g.sh = TBits - MSBNumber(&prod, 1);
+			g.dn = T(prod << g.sh);
+			g.v = ReciprocalUnit(g.dn);
+		}
+	}
+	/**Divisors own their tables and are not copied.*/
+	TrialDivisor(const Self&) = delete;
+	/**Divisors own their tables and are not copied.*/
+	void operator=(const Self&) = delete;
+	/**Free the tables.*/
+	~TrialDivisor()
+	{
+		delete[] m_primes;
+		delete[] m_groups;
+	}
+	/**Find the smallest of the primes that divides a number.
+	\param arr The number.
+	\param s The size of arr.
+	\return The prime, or 0 when none of them divides the number.*/
+	std::size_t Find(const T* arr, const std::size_t s) const
+	{
+		for (std::size_t i = 0; i < m_groupCount; ++i)
+		{
+			const Group& g = m_groups[i];
+			const T r = ModArrayPre(arr, s, g.dn, g.v, g.sh);
+			for (std::size_t j = g.first; j < g.last; ++j)
+				if (r % m_primes[j] == 0)
+					return m_primes[j];
+		}
+		return 0;
+	}
+	/**Get the largest prime divided by.
+	\return The prime, or 2 when there are no odd primes.*/
+	std::size_t Largest() const
+	{
+		return m_size ? m_primes[m_size - 1] : 2;
+	}
+private:
+	/**A run of primes whose product fits in a unit.*/
+	struct Group
+	{
+		/**The product, shifted up until its high bit is set.*/
+		T dn;
+		/**The reciprocal of dn.*/
+		T v;
+		/**The amount the product was shifted.*/
+		std::size_t sh;
+		/**The first prime of the group.*/
+		std::size_t first;
+		/**One past the last prime of the group.*/
+		std::size_t last;
+	};
+	/**The primes.*/
+	uint32_t* m_primes;
+	/**The amount of primes.*/
+	std::size_t m_size;
+	/**The groups.*/
+	Group* m_groups;
+	/**The amount of groups.*/
+	std::size_t m_groupCount;
+};
+/**Get the trial divisor used by IsProbablePrime.  It is made on the first
+call.
+\return The primes below 2^12 that fit in a unit.*/
+template<typename T>
+inline const TrialDivisor<T>& DefaultTrialDivisor()
+{
+	static const TrialDivisor<T> divisor;
+	return divisor;
+}
+/**Find the Jacobi symbol of two units.
+\param a The top.
+\param b The bottom.  Must be odd.
+\return (a / b), which is -1, 0 or 1.*/
+inline int JacobiUnit(uint64_t a, uint64_t b)
+{
+	int j = 1;
+	a %= b;
+	while (a)
+	{
+		while (!(a & 1))
+		{
+			a >>= 1;
+			if ((b & 7) == 3 || (b & 7) == 5)
+				j = -j;
+		}
+		std::swap(a, b);
+		if ((a & 3) == 3 && (b & 3) == 3)
+			j = -j;
+		a %= b;
+	}
+	return b == 1 ? j : 0;
+}
+/**Find the Jacobi symbol of a small number over a big one.
+\param d The top.  Its absolute value must be odd and fit in a unit.
+\param m The bottom.  Must be odd.
+\param n The size of m.
+\return (d / m), which is -1, 0 or 1.*/
+template<typename T>
+inline int JacobiArray(const int64_t d, const T* m, const std::size_t n)
+{
+	const uint64_t a = uint64_t(d < 0 ? -d : d);
+	/*(a / m) = (m / a) unless both are 3 mod 4, and (-1 / m) = -1 when m is
+	3 mod 4.*/
+	int j = JacobiUnit(uint64_t(ModArray(m, n, T(a))), a);
+	if ((a & 3) == 3 && (m[0] & 3) == 3)
+		j = -j;
+	if (d < 0 && (m[0] & 3) == 3)
+		j = -j;
+	return j;
+}
+/**Test a number with the strong probable prime test (Miller-Rabin).  The
+powers are taken in the Montgomery form, so no step divides.
+\param red A reducer for the number.  The number must be odd and above 2.
+\param base The base.
+\return False if the number is composite, true if it is a strong probable
+prime to the base.*/
+template<typename DataType, std::size_t Units, std::size_t S>
+bool MillerRabin(MontgomeryReducer<DataType, Units>& red,
+	const BigNum<DataType, S>& base)
+{
+	const std::size_t n = red.Size();
+	const DataType* m = red.Modulus();
+	BigNum<DataType, 0> unit;
+	const DataType d1 = 1;
+	unit.PushArray(&d1, 1);
+	BigNum<DataType, Units> g;
+	BigNum<DataType, Units> one;
+	red.ToMont(g, base);
+	red.ToMont(one, unit);
+	DataType* minus = new DataType[n + n + n];
+	DataType* e = minus + n;
+	DataType* x = e + n;
+	/*-1 is m - 1 in the Montgomery form too.*/
+	std::memcpy(minus, m, n * sizeof(DataType));
+	SubArray(minus, n, one.Begin(), n);
+	/*m - 1 = e 2^s*/
+	std::memcpy(e, m, n * sizeof(DataType));
+	e[0] ^= 1;
+	const std::size_t s = TrailingZeros(e, n);
+	ShiftInsigB(e, n, s);
+	PowModArray(x, g.Begin(), e, RealSize(e, n), n, one.Begin(),
+		[&](DataType* r, const DataType* a, const DataType* b)
+	{
+		red.Mul(r, a, b);
+	});
+	bool prime = CompareArray(x, n, one.Begin(), n) == 0
+		|| CompareArray(x, n, minus, n) == 0;
+	for (std::size_t i = 1; i < s && !prime; ++i)
+	{
+		red.Mul(x, x, x);
+		if (CompareArray(x, n, minus, n) == 0)
+			prime = true;
+		else if (CompareArray(x, n, one.Begin(), n) == 0)
+			break;
+	}
+	delete[] minus;
+	return prime;
+}
+/**Test a number with the strong probable prime test (Miller-Rabin).
+\param num The number.  Must be odd and above 2.
+\param base The base.
+\return False if the number is composite, true if it is a strong probable
+prime to the base.*/
+template<typename DataType, std::size_t Units, std::size_t S>
+bool MillerRabin(const BigNum<DataType, Units>& num,
+	const BigNum<DataType, S>& base)
+{
+	MontgomeryReducer<DataType, Units> red(num);
+	return MillerRabin(red, base);
+}
+/**Test a number with the strong Lucas probable prime test, with the
+parameters from Selfridge's method: D is the first of 5, -7, 9, -11, ... with
+(D / n) = -1, P = 1 and Q = (1 - D) / 4.  U and V are doubled up the bits of
+n + 1 in the Montgomery form, so no step divides.
+\param red A reducer for the number.  The number must be odd and above 2.
+\return False if the number is composite, true if it is a strong Lucas
+probable prime.*/
+template<typename DataType, std::size_t Units>
+bool StrongLucas(MontgomeryReducer<DataType, Units>& red)
+{
+	using Int = MontgomeryInt<DataType, Units>;
+	const std::size_t TBits = sizeof(DataType) * 8;
+	const std::size_t n = red.Size();
+	const DataType* m = red.Modulus();
+	int64_t d = 5;
+	for (std::size_t tries = 0;; ++tries)
+	{
+		const uint64_t a = uint64_t(d < 0 ? -d : d);
+		if (a > uint64_t(DataType(~DataType(0))))
+			throw std::runtime_error("No Lucas parameter fits in a unit.");
+		const int j = JacobiArray(d, m, n);
+		if (j == -1)
+			break;
+		if (j == 0 && !(n == 1 && m[0] == a))
+			return false;
+		/*Squares have no such D, so look for one after a few tries.*/
+		if (tries == 3)
+		{
+			BigNum<DataType, 0> num;
+			BigNum<DataType, 0> r;
+			num.PushArray(m, n);
+			ISqrtRem(num, &r);
+			if (r.RealSize() == 0)
+				return false;
+		}
+		d = d > 0 ? -(d + 2) : 2 - d;
+	}
+	const auto make = [&](const int64_t v)
+	{
+		BigNum<DataType, 0> b;
+		const DataType u = DataType(v < 0 ? -v : v);
+		b.PushArray(&u, 1);
+		Int r(red, b);
+		if (v < 0)
+		{
+			Int z(red);
+			z -= r;
+			return z;
+		}
+		return r;
+	};
+	const Int zero(red);
+	const Int one = make(1);
+	const Int md = make(d);
+	const Int mq = make((1 - d) / 4);
+	/*n + 1 = k 2^s*/
+	DataType* k = new DataType[n + 1];
+	std::memcpy(k, m, n * sizeof(DataType));
+	k[n] = 0;
+	AddArray(k, n + 1, DataType(1));
+	const std::size_t s = TrailingZeros(k, n + 1);
+	ShiftInsigB(k, n + 1, s);
+	Int u = one;
+	Int v = one;
+	Int qk = mq;
+	for (std::size_t i = MSBNumber(k, n + 1) - 1; i-- > 0;)
+	{
+		/*U(2j) = U(j) V(j), V(2j) = V(j)^2 - 2 Q^j*/
+		u *= v;
+		v *= v;
+		v -= qk;
+		v -= qk;
+		qk *= qk;
+		if ((k[i / TBits] >> (i % TBits)) & 1)
+		{
+			/*U(j+1) = (U(j) + V(j)) / 2, V(j+1) = (D U(j) + V(j)) / 2*/
+			Int t = u;
+			u += v;
+			u.Halve();
+			t *= md;
+			t += v;
+			v = t;
+			v.Halve();
+			qk *= mq;
+		}
+	}
+	delete[] k;
+	if (u == zero || v == zero)
+		return true;
+	for (std::size_t r = 1; r < s; ++r)
+	{
+		v *= v;
+		v -= qk;
+		v -= qk;
+		if (v == zero)
+			return true;
+		qk *= qk;
+	}
+	return false;
+}
+/**Test a number with the strong Lucas probable prime test (see the other
+overload).
+\param num The number.  Must be odd and above 2.
+\return False if the number is composite, true if it is a strong Lucas
+probable prime.*/
+template<typename DataType, std::size_t Units>
+bool StrongLucas(const BigNum<DataType, Units>& num)
+{
+	MontgomeryReducer<DataType, Units> red(num);
+	return StrongLucas(red);
+}
+/**Test a number with the Baillie-PSW test: Miller-Rabin to base 2 and the
+strong Lucas test.  No composite is known to pass both.
+\param red A reducer for the number.  The number must be odd and above 2.
+\param rounds The amount of extra Miller-Rabin tests, to the bases 3, 5, 7,
+...
+\return False if the number is composite, true if it is a probable prime.*/
+template<typename DataType, std::size_t Units>
+bool BPSW(MontgomeryReducer<DataType, Units>& red,
+	const std::size_t rounds = 0)
+{
+	BigNum<DataType, 0> base;
+	base = DataType(2);
+	if (!MillerRabin(red, base) || !StrongLucas(red))
+		return false;
+	std::size_t count;
+	const uint16_t* primes = SmallPrimes(count);
+	for (std::size_t i = 1; i <= rounds && i < count; ++i)
+	{
+		base = DataType(primes[i]);
+		if (!MillerRabin(red, base))
+			return false;
+	}
+	return true;
+}
+/**Screen a number with trial division by the small primes.
+\param num The number.
+\return 0 if the number is composite (or below 2), 1 if it is prime and 2 if
+it has no small factor but is too big to be sure.*/
+template<typename DataType, std::size_t Units>
+int PrimeScreen(const BigNum<DataType, Units>& num)
+{
+	const std::size_t n = num.RealSize();
+	if (n == 0)
+		return 0;
+	const DataType* a = num.Begin();
+	const uint64_t v = n * sizeof(DataType) <= 8 ? ReadBits(a, n, 0, 64)
+		: ~uint64_t(0);
+	if (v == 1)
+		return 0;
+	if (!(a[0] & 1))
+		return v == 2 ? 1 : 0;
+	const TrialDivisor<DataType>& td = DefaultTrialDivisor<DataType>();
+	const std::size_t p = td.Find(a, n);
+	if (p)
+		return v == p ? 1 : 0;
+	/*Every composite below p^2 has a factor below p.*/
+	const uint64_t last = td.Largest();
+	return v < last * last ? 1 : 2;
+}
+/**Test if a number is prime: trial division by the small primes, then the
+Baillie-PSW test (see BPSW).
+\param num The number.
+\param rounds The amount of extra Miller-Rabin tests.
+\return False if the number is composite, true if it is prime or a probable
+prime.*/
+template<typename DataType, std::size_t Units>
+bool IsProbablePrime(const BigNum<DataType, Units>& num,
+	const std::size_t rounds = 0)
+{
+	const int screen = PrimeScreen(num);
+	if (screen != 2)
+		return screen == 1;
+	MontgomeryReducer<DataType, Units> red(num);
+	return BPSW(red, rounds);
+}
+/**Test many numbers at once.  All of them are screened with trial division
+first, which throws out most composites cheaply, and only the rest get the
+Baillie-PSW test.
+\param nums The numbers.
+\param count The amount of numbers.
+\param out [out] For each number, false if it is composite and true if it is
+prime or a probable prime.
+\param rounds The amount of extra Miller-Rabin tests.
+\return The amount of probable primes.*/
+template<typename DataType, std::size_t Units>
+std::size_t IsProbablePrime(const BigNum<DataType, Units>* nums,
+	const std::size_t count, bool* out, const std::size_t rounds = 0)
+{
+	std::size_t found = 0;
+	unsigned char* screen = new unsigned char[count];
+	for (std::size_t i = 0; i < count; ++i)
+		screen[i] = (unsigned char)PrimeScreen(nums[i]);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (screen[i] == 2)
+		{
+			MontgomeryReducer<DataType, Units> red(nums[i]);
+			out[i] = BPSW(red, rounds);
+		}
+		else
+			out[i] = screen[i] == 1;
+		if (out[i])
+			++found;
+	}
+	delete[] screen;
+	return found;
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+
+
+#include <cstddef>
+#include <cstring>
+
+#include "BigNum.hpp"
+
+namespace cg {
+
+/**Find the integer square root of a number and the remainder.  Uses
+Zimmermann's Karatsuba square root (see cg::SqrtRemArray), so the cost follows
+that of multiplication.
+\param a The number.
+\param r [out] a - s^2, or nullptr.
+\return s, the largest number with s^2 <= a.*/
+template<typename DataType, std::size_t Units>
+BigNum<DataType, Units> ISqrtRem(const BigNum<DataType, Units>& a,
+	BigNum<DataType, Units>* r)
+{
+	const std::size_t n = a.RealSize();
+	BigNum<DataType, Units> s;
+	s = DataType(0);
+	s.ExpandTo((n + 1) / 2);
+	if (r)
+	{
+		*r = DataType(0);
+		r->ExpandTo(n);
+	}
+	if (n == 0)
+		return s;
+	SqrtRemArray(s.Begin(), r ? r->Begin() : (DataType*)nullptr, a.Begin(), n);
+	return s;
+}
+/**Find the integer square root of a number.
+\param a The number.
+\return s, the largest number with s^2 <= a.*/
+template<typename DataType, std::size_t Units>
+BigNum<DataType, Units> ISqrt(const BigNum<DataType, Units>& a)
+{
+	return ISqrtRem(a, (BigNum<DataType, Units>*)nullptr);
+}
+/**Find the integer k-th root of a number with Newton's method (see
+cg::RootArray).
+\param a The number.
+\param k The root.  Must not be zero.
+\return s, the largest number with s^k <= a.*/
+template<typename DataType, std::size_t Units>
+BigNum<DataType, Units> IRoot(const BigNum<DataType, Units>& a,
+	const std::size_t k)
+{
+	if (k == 0)
+		throw std::invalid_argument("Root is zero.");
+	if (k == 2)
+		return ISqrt(a);
+	const std::size_t n = a.RealSize();
+	BigNum<DataType, Units> s;
+	s = DataType(0);
+	s.ExpandTo(n / k + 1);
+	if (n == 0)
+		return s;
+	RootArray(s.Begin(), a.Begin(), n, k);
+	return s;
+}
+
+}
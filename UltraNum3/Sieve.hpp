@@ -0,0 +1,273 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace cg {
+
+/**Sieve a run of bytes of the mod 30 wheel.  Bit k of byte j stands for
+30 j + r(k), with r = 1, 7, 11, 13, 17, 19, 23, 29, so multiples of 2, 3 and
+5 take no space.  A bit is left set if its number is not a multiple of any of
+the sieving primes below it.  The run is sieved in segments that fit in the
+cache, and the next multiple of each prime in each wheel class is kept
+between segments.
+\param out [out] The bytes, b1 - b0.
+\param b0 The first byte.
+\param b1 One past the last byte.
+\param primes The sieving primes, from 7 up through sqrt(30 b1).
+\param np The amount of sieving primes.
+\param next Work space, 8 np units.
+\param seg The segment size in bytes.*/
+inline void SieveWheel(uint8_t* out, const uint64_t b0, const uint64_t b1,
+	const uint32_t* primes, std::size_t np, uint64_t* next,
+	const std::size_t seg)
+{
+	static const uint8_t residue[8] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+	static const uint8_t bit[30] = { 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 2, 0, 3,
+		0, 0, 0, 4, 0, 5, 0, 0, 0, 6, 0, 0, 0, 0, 0, 7 };
+	std::memset(out, 0xff, std::size_t(b1 - b0));
+	const uint64_t end = b1 * 30;
+	while (np && uint64_t(primes[np - 1]) * primes[np - 1] >= end)
+		--np;
+	/*The multiples p q with q = r(i) mod 30 are 30 p apart, so they are p
+	bytes apart and always on the same bit.*/
+	for (std::size_t j = 0; j < np; ++j)
+	{
+		const uint64_t p = primes[j];
+		uint64_t q = (b0 * 30 + p - 1) / p;
+		if (q < p)
+			q = p;
+		for (std::size_t i = 0; i < 8; ++i)
+			next[8 * j + i] = p * (q + (residue[i] + 30 - q % 30) % 30) / 30;
+	}
+	for (uint64_t s = b0; s < b1; s += seg)
+	{
+		const uint64_t e = s + seg < b1 ? s + seg : b1;
+		for (std::size_t j = 0; j < np; ++j)
+		{
+			const uint64_t p = primes[j];
+			const std::size_t pm = std::size_t(p % 30);
+			for (std::size_t i = 0; i < 8; ++i)
+			{
+				const uint8_t mask = uint8_t(~(1u << bit[pm * residue[i] % 30]));
+				uint64_t k = next[8 * j + i];
+				for (; k < e; k += p)
+					out[k - b0] &= mask;
+				next[8 * j + i] = k;
+			}
+		}
+	}
+	/*1 is not a prime.*/
+	if (b0 == 0 && b1 > 0)
+		out[0] &= 0xfe;
+}
+inline uint32_t* PrimeTable(const uint64_t limit, std::size_t& count,
+	std::size_t threads = 1);
+/**Sieve the wheel bytes [b0, b1) (see SieveWheel) in chunks spread over
+threads, and hand the chunks to a function in order.  The function is only
+called from the calling thread.
+\param b0 The first byte.
+\param b1 One past the last byte.
+\param threads The amount of threads.  0 uses one per core.
+\param f The function, `f(bytes, c0, c1)` for the bytes [c0, c1).*/
+template<typename F>
+inline void SieveChunks(const uint64_t b0, const uint64_t b1,
+	std::size_t threads, F&& f)
+{
+	if (b0 >= b1)
+		return;
+	/*The ranges end below 2^63, which keeps 30 b1 and the multiples in
+	SieveWheel from wrapping.*/
+	if (b1 > ((uint64_t(1) << 63) + 28) / 30)
+		throw std::invalid_argument("Sieve limit is too big.");
+	uint64_t root = uint64_t(std::sqrt(double(b1 * 30)));
+	while (root * root > b1 * 30)
+		--root;
+	while ((root + 1) * (root + 1) <= b1 * 30)
+		++root;
+	/*Segments fit in the L1 cache, or in the L2 cache when there are so many
+	big sieving primes that checking them for each segment costs more than
+	the misses.*/
+	std::size_t seg = std::size_t(1) << 15;
+	while (seg < root / 4 && seg < (std::size_t(1) << 18))
+		seg *= 2;
+	const std::size_t chunk = seg * 32;
+	std::size_t np = 0;
+	uint32_t* table = nullptr;
+	if (root >= 7)
+		table = PrimeTable(root + 1, np);
+	/*Skip 2, 3 and 5, the wheel has them.*/
+	const uint32_t* primes = np > 3 ? table + 3 : table;
+	np = np > 3 ? np - 3 : 0;
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	const uint64_t chunks = (b1 - b0 + chunk - 1) / chunk;
+	if (threads == 0)
+		threads = 1;
+	if (threads > chunks)
+		threads = std::size_t(chunks);
+	uint8_t* out = new uint8_t[threads * chunk];
+	uint64_t* next = new uint64_t[threads * 8 * np + 1];
+	std::thread* workers = new std::thread[threads];
+	for (uint64_t c = b0; c < b1; c += threads * chunk)
+	{
+		std::size_t used = 0;
+		for (; used < threads && c + used * chunk < b1; ++used)
+		{
+			const uint64_t c0 = c + used * chunk;
+			const uint64_t c1 = c0 + chunk < b1 ? c0 + chunk : b1;
+			uint8_t* o = out + used * chunk;
+			uint64_t* x = next + used * 8 * np;
+			if (used)
+				workers[used] = std::thread([=]()
+			{
+				SieveWheel(o, c0, c1, primes, np, x, seg);
+			});
+			else
+				SieveWheel(o, c0, c1, primes, np, x, seg);
+		}
+		for (std::size_t t = 1; t < used; ++t)
+			workers[t].join();
+		for (std::size_t t = 0; t < used; ++t)
+		{
+			const uint64_t c0 = c + t * chunk;
+			f((const uint8_t*)(out + t * chunk), c0,
+				c0 + chunk < b1 ? c0 + chunk : b1);
+		}
+	}
+	delete[] workers;
+	delete[] next;
+	delete[] out;
+	delete[] table;
+}
+/**Find the primes in a range with a segmented sieve of Eratosthenes on the
+mod 30 wheel.  The segments are sieved on several threads, but the primes are
+handed out in order from the calling thread.
+\param lo The start of the range.
+\param hi One past the end of the range.  Must be below 2^63.  The primes up
+to sqrt(hi) are kept with 64 bytes of work space each per thread, so the
+top of that is out of reach of most memories.
+\param callback Called as `callback(p)` for each prime p, smallest first.
+\param threads The amount of threads.  0 uses one per core.*/
+template<typename F>
+inline void SievePrimes(const uint64_t lo, const uint64_t hi, F&& callback,
+	const std::size_t threads = 0)
+{
+	static const uint8_t residue[8] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+	static const uint64_t wheel[3] = { 2, 3, 5 };
+	for (std::size_t i = 0; i < 3; ++i)
+		if (wheel[i] >= lo && wheel[i] < hi)
+			callback(wheel[i]);
+	if (lo >= hi)
+		return;
+	SieveChunks(lo / 30, hi / 30 + (hi % 30 ? 1 : 0), threads,
+		[&](const uint8_t* bytes, const uint64_t c0, const uint64_t c1)
+	{
+		for (uint64_t j = c0; j < c1; ++j)
+		{
+			const uint8_t b = bytes[j - c0];
+			for (std::size_t k = 0; k < 8; ++k)
+			{
+				const uint64_t v = j * 30 + residue[k];
+				if (((b >> k) & 1) && v >= lo && v < hi)
+					callback(v);
+			}
+		}
+	});
+}
+/**Count the primes in a range (see SievePrimes).
+\param lo The start of the range.
+\param hi One past the end of the range.  Must be below 2^63.  The primes up
+to sqrt(hi) are kept with 64 bytes of work space each per thread, so the
+top of that is out of reach of most memories.
+\param threads The amount of threads.  0 uses one per core.
+\return The amount of primes.*/
+inline uint64_t PrimeCount(const uint64_t lo, const uint64_t hi,
+	const std::size_t threads = 0)
+{
+	static const uint8_t residue[8] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+	uint64_t count = 0;
+	for (uint64_t p = 2; p <= 5; p += p == 2 ? 1 : 2)
+		if (p >= lo && p < hi)
+			++count;
+	if (lo >= hi)
+		return count;
+	const uint64_t b0 = lo / 30;
+	const uint64_t b1 = hi / 30 + (hi % 30 ? 1 : 0);
+	SieveChunks(b0, b1, threads,
+		[&](const uint8_t* bytes, const uint64_t c0, const uint64_t c1)
+	{
+		for (uint64_t j = c0; j < c1;)
+		{
+			/*Count 8 bytes at a time away from the ends of the range.*/
+			if (j != b0 && j + 8 < b1 && j + 8 <= c1)
+			{
+				uint64_t x;
+				std::memcpy(&x, bytes + (j - c0), 8);
+				x -= (x >> 1) & 0x5555555555555555ull;
+				x = (x & 0x3333333333333333ull)
+					+ ((x >> 2) & 0x3333333333333333ull);
+				x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+				count += (x * 0x0101010101010101ull) >> 56;
+				j += 8;
+				continue;
+			}
+			const uint8_t b = bytes[j - c0];
+			for (std::size_t k = 0; k < 8; ++k)
+			{
+				const uint64_t v = j * 30 + residue[k];
+				if (((b >> k) & 1) && v >= lo && v < hi)
+					++count;
+			}
+			++j;
+		}
+	});
+	return count;
+}
+/**Make a table of the primes below a limit, such as for trial division.
+\param limit One past the largest number to look at.  Must be at most 2^32.
+\param count [out] The amount of primes.
+\param threads The amount of threads.  0 uses one per core.
+\return The primes, smallest first.  Free with delete[].*/
+inline uint32_t* PrimeTable(const uint64_t limit, std::size_t& count,
+	std::size_t threads)
+{
+	if (limit > (uint64_t(1) << 32))
+		throw std::invalid_argument("Prime table limit is too big.");
+	count = std::size_t(PrimeCount(0, limit, threads));
+	uint32_t* table = new uint32_t[count + 1];
+	std::size_t i = 0;
+	SievePrimes(0, limit, [&](const uint64_t p)
+	{
+		table[i++] = uint32_t(p);
+	}, threads);
+	return table;
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Thresholds.hpp"
+
+namespace cg {
+
+std::size_t Thresholds::Karatsuba = 32;
+std::size_t Thresholds::Toom3 = 512;
+std::size_t Thresholds::Toom4 = 1024;
+std::size_t Thresholds::NTT = 4096;
+std::size_t Thresholds::BurnikelZiegler = 60;
+std::size_t Thresholds::Newton = 1000000;
+std::size_t Thresholds::Lehmer = 4;
+std::size_t Thresholds::HalfGCD = 200;
+
+}
@@ -0,0 +1,60 @@
+/*
+
+(C) Matthew Swanson
+
+This file is part of UltraNum2.
+
+UltraNum2 is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+any later version.
+
+UltraNum2 is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UltraNum2.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <cstddef>
+
+namespace cg {
+
+/**The sizes (in units of the array type) at which the math functions switch
+from one algorithm to the next.  They are shared by all types and may be
+changed at runtime to tune for a machine.*/
+class Thresholds {
+public:
+	/**The smaller operand of a multiplication must have at least this many
+	units before Karatsuba is used instead of the schoolbook method.*/
+	static std::size_t Karatsuba;
+	/**The smaller operand of a multiplication must have at least this many
+	units before Toom-3 is used instead of Karatsuba.*/
+	static std::size_t Toom3;
+	/**The smaller operand of a multiplication must have at least this many
+	units before Toom-4 is used instead of Toom-3.*/
+	static std::size_t Toom4;
+	/**The smaller operand of a multiplication must have at least this many
+	units before the number theoretic transform is used.*/
+	static std::size_t NTT;
+	/**The divisor of a division must have at least this many units before
+	the recursive (Burnikel and Ziegler) division splits it instead of
+	using Knuth algorithm D.*/
+	static std::size_t BurnikelZiegler;
+	/**The divisor and quotient of a division must have at least this many
+	units before the divisor's Newton reciprocal is used by
+	DivArray_Newton.*/
+	static std::size_t Newton;
+	/**The smaller number of a GCD must have at least this many units before
+	Lehmer's algorithm is used instead of the binary GCD.*/
+	static std::size_t Lehmer;
+	/**The smaller number of a GCD must have at least this many units before
+	the half-GCD is used instead of Lehmer's algorithm.*/
+	static std::size_t HalfGCD;
+};
+
+}
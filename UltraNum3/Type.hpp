@@ -38,6 +38,16 @@ public:
 	/*There is intentionaly no Type here.*/
 	using Type = T;
 };
+#if defined(__SIZEOF_INT128__)
+/**\sa DemoteType*/
+template<>
+class DemoteType<unsigned __int128> {
+public:
+	/**The Type that has been demoted.*/
+	using Type = uint64_t;
+
+};
+#endif
 /**\sa DemoteType*/
 template<>
 class DemoteType<uint64_t> {
@@ -77,6 +87,18 @@ public:
 	/*There is intentionaly no Type here.*/
 	using Type = T;
 };
+#if defined(__SIZEOF_INT128__)
+/**\sa PromoteType
+The compilers that have a 128 bit type (GCC and Clang on 64 bit targets)
+multiply and divide 64 bit units with it.  Others use the intrinsics in
+BasicMathFuncs.hpp, or half units.*/
+template<> class PromoteType<uint64_t> {
+public:
+	/**The Type that has been promoted.*/
+	using Type = unsigned __int128;
+
+};
+#endif
 /**\sa PromoteType*/
 template<> class PromoteType<uint32_t> {
 public:
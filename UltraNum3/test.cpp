@@ -6,19 +6,89 @@
 #include <iostream>
 
 #include "BigNum.hpp"
+#include "Barrett.hpp"
+#include "Montgomery.hpp"
+#include "PowMod.hpp"
+#include "Roots.hpp"
+#include "Prime.hpp"
+#include "Sieve.hpp"
+#include "Combinatorics.hpp"
+#include "Fibonacci.hpp"
+#include "Constants.hpp"
+#include "Kernels.hpp"
 #include "List.hpp"
 #include "Timer.hpp"
 
 uint64_t RandomU64();
 uint64_t RandomU64_2();
+template<typename T>
 bool TestBigNumAdd(std::size_t amt);
+template<typename T>
 bool TestBigNumDiv(std::size_t amt);
+template<typename T>
 bool TestBigNumMod(std::size_t amt);
+template<typename T>
 bool TestBigLShift(std::size_t amt);
+template<typename T>
 bool TestBigRShift(std::size_t amt);
+template<typename T>
 bool TestBigNumCompare(std::size_t amt);
+template<typename T>
 bool TestBigNumSub(std::size_t amt);
+template<typename T>
 bool TestBigNumMul(std::size_t amt);
+template<typename T>
+bool TestAddSubCarry(std::size_t amt);
+template<typename T>
+void RandomArray(T* arr, std::size_t s);
+template<typename T>
+bool TestMulKaratsuba(std::size_t amt);
+template<typename T>
+bool TestMulToom(std::size_t amt);
+template<typename T>
+bool TestMulNTT(std::size_t amt);
+template<typename T>
+bool TestAddMul(std::size_t amt);
+template<typename T>
+bool TestScalarMul(std::size_t amt);
+bool TestKernels(std::size_t amt);
+template<typename T>
+bool TestSqr(std::size_t amt);
+template<typename T>
+void RandomDivArray(T* arr, std::size_t s);
+template<typename T>
+bool TestDivKnuth(std::size_t amt);
+template<typename T>
+bool TestDivSplit(std::size_t amt);
+template<typename T>
+bool TestDivNewton(std::size_t amt);
+template<typename T>
+bool TestDivUnit(std::size_t amt);
+template<typename T>
+bool TestDivMod(std::size_t amt);
+template<typename T>
+bool TestBarrett(std::size_t amt);
+template<typename T>
+bool TestMontgomery(std::size_t amt);
+template<typename T>
+bool TestPowMod(std::size_t amt);
+template<typename T>
+bool TestGCD(std::size_t amt);
+template<typename T>
+bool TestExtGCD(std::size_t amt);
+template<typename T>
+bool TestRoot(std::size_t amt);
+template<typename T>
+cg::BigNum<T, 0> BigFromU64(uint64_t v);
+template<typename T>
+bool TestPrime(std::size_t amt);
+bool TestSieve(std::size_t amt);
+template<typename T>
+bool TestFactorial(std::size_t amt);
+template<typename T>
+bool TestFibonacci(std::size_t amt);
+template<typename T>
+bool TestConstants(std::size_t amt);
 
 int main()
 {
@@ -42,14 +112,68 @@ int main()
 
 
 
-	TestBigLShift		(100000);
-	TestBigRShift		(100000);
-	TestBigNumSub		(100000);
-	TestBigNumDiv		(100000);
-	TestBigNumCompare	(100000);
-	TestBigNumAdd		(100000);
-	TestBigNumMul		(100000);
-	TestBigNumMod		(100000);
+	TestBigLShift<uint16_t>(100000);
+	TestBigLShift<uint64_t>(100000);
+	TestBigRShift<uint16_t>(100000);
+	TestBigRShift<uint64_t>(100000);
+	TestBigNumSub<uint16_t>(100000);
+	TestBigNumSub<uint64_t>(100000);
+	TestBigNumDiv<uint16_t>(100000);
+	TestBigNumDiv<uint64_t>(100000);
+	TestBigNumCompare<uint16_t>(100000);
+	TestBigNumCompare<uint64_t>(100000);
+	TestBigNumAdd<uint16_t>(100000);
+	TestBigNumAdd<uint64_t>(100000);
+	TestBigNumMul<uint16_t>(100000);
+	TestBigNumMul<uint64_t>(100000);
+	TestBigNumMod<uint16_t>(100000);
+	TestBigNumMod<uint64_t>(100000);
+	TestAddSubCarry<uint16_t>(100000);
+	TestAddSubCarry<uint64_t>(100000);
+	TestMulKaratsuba<uint16_t>(300);
+	TestMulKaratsuba<uint64_t>(300);
+	TestMulToom<uint16_t>(100);
+	TestMulToom<uint64_t>(100);
+	TestMulNTT<uint16_t>(50);
+	TestMulNTT<uint64_t>(50);
+	TestSqr<uint16_t>(50);
+	TestSqr<uint64_t>(50);
+	TestAddMul<uint16_t>(10000);
+	TestAddMul<uint64_t>(10000);
+	TestScalarMul<uint16_t>(10000);
+	TestScalarMul<uint64_t>(10000);
+	TestKernels		(10000);
+	TestDivKnuth<uint16_t>(10000);
+	TestDivKnuth<uint64_t>(10000);
+	TestDivSplit<uint16_t>(100);
+	TestDivSplit<uint64_t>(100);
+	TestDivNewton<uint16_t>(300);
+	TestDivNewton<uint64_t>(300);
+	TestDivUnit<uint16_t>(100000);
+	TestDivUnit<uint64_t>(100000);
+	TestDivMod<uint16_t>(10000);
+	TestDivMod<uint64_t>(10000);
+	TestBarrett<uint16_t>(10000);
+	TestBarrett<uint64_t>(10000);
+	TestMontgomery<uint16_t>(10000);
+	TestMontgomery<uint64_t>(10000);
+	TestPowMod<uint16_t>(1000);
+	TestPowMod<uint64_t>(1000);
+	TestGCD<uint16_t>(3000);
+	TestGCD<uint64_t>(3000);
+	TestExtGCD<uint16_t>(3000);
+	TestExtGCD<uint64_t>(3000);
+	TestRoot<uint16_t>(3000);
+	TestRoot<uint64_t>(3000);
+	TestPrime<uint16_t>(300);
+	TestPrime<uint64_t>(300);
+	TestSieve(100);
+	TestFactorial<uint16_t>(100);
+	TestFactorial<uint64_t>(100);
+	TestFibonacci<uint16_t>(100);
+	TestFibonacci<uint64_t>(100);
+	TestConstants<uint16_t>(20);
+	TestConstants<uint64_t>(20);
 
 	int stop = 0;
 	return stop;
@@ -76,6 +200,15 @@ uint64_t RandomU64_2()
 	return n;
 }
 
+/**The static size of a BigNum of T units that holds 64 bits.  Sizes are
+even, so 64 bit units get 2.*/
+template<typename T>
+struct Units64
+{
+	static const std::size_t value = (8 / sizeof(T) + 1) / 2 * 2;
+};
+
+template<typename T>
 bool TestBigNumAdd(std::size_t amt)
 {
 	std::srand((unsigned int)std::time(0));
@@ -84,10 +217,10 @@ bool TestBigNumAdd(std::size_t amt)
 	{
 		uint64_t n1 = RandomU64();
 		uint64_t n2 = RandomU64();
-		auto a = cg::BigNum<uint16_t, 4>();
-		a.PushArray(cg::AsArray<uint16_t>(n1), 4);
-		auto b = cg::BigNum<uint16_t, 4>();
-		b.PushArray(cg::AsArray<uint16_t>(n2), 4);
+		auto a = cg::BigNum<T, Units64<T>::value>();
+		a.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
+		auto b = cg::BigNum<T, Units64<T>::value>();
+		b.PushArray(cg::AsArray<T>(n2), 8 / sizeof(T));
 
 		uint64_t answer = n1 + n2;
 		auto funcLambda = [&]()
@@ -105,6 +238,7 @@ bool TestBigNumAdd(std::size_t amt)
 
 	return false;
 }
+template<typename T>
 bool TestBigNumCompare(std::size_t amt)
 {
 	std::srand((unsigned int)std::time(0));
@@ -114,10 +248,10 @@ bool TestBigNumCompare(std::size_t amt)
 	{
 		uint64_t n1 = RandomU64_2();
 		uint64_t n2 = RandomU64_2();
-		auto a = cg::BigNum<uint16_t, 4>();
-		a.PushArray(cg::AsArray<uint16_t>(n1), 4);
-		auto b = cg::BigNum<uint16_t, 4>();
-		b.PushArray(cg::AsArray<uint16_t>(n2), 4);
+		auto a = cg::BigNum<T, Units64<T>::value>();
+		a.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
+		auto b = cg::BigNum<T, Units64<T>::value>();
+		b.PushArray(cg::AsArray<T>(n2), 8 / sizeof(T));
 
 		bool lt = n1 < n2;
 		bool ne = n1 != n2;
@@ -133,6 +267,7 @@ bool TestBigNumCompare(std::size_t amt)
 
 	return false;
 }
+template<typename T>
 bool TestBigNumSub(std::size_t amt)
 {
 	std::srand((unsigned int)std::time(0));
@@ -147,10 +282,10 @@ bool TestBigNumSub(std::size_t amt)
 			n1 = n2;
 			n2 = x;
 		}
-		auto a = cg::BigNum<uint16_t, 4>();
-		a.PushArray(cg::AsArray<uint16_t>(n1), 4);
-		auto b = cg::BigNum<uint16_t, 4>();
-		b.PushArray(cg::AsArray<uint16_t>(n2), 4);
+		auto a = cg::BigNum<T, Units64<T>::value>();
+		a.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
+		auto b = cg::BigNum<T, Units64<T>::value>();
+		b.PushArray(cg::AsArray<T>(n2), 8 / sizeof(T));
 		uint64_t answer = n1 - n2;
 		auto funcLambda = [&]()
 		{
@@ -166,6 +301,7 @@ bool TestBigNumSub(std::size_t amt)
 
 	return false;
 }
+template<typename T>
 bool TestBigNumDiv(std::size_t amt)
 {
 	std::srand((unsigned int)std::time(0));
@@ -182,10 +318,10 @@ bool TestBigNumDiv(std::size_t amt)
 		}
 		if (n2 == 0)
 			n2 = 1;
-		auto a = cg::BigNum<uint16_t, 4>();
-		a.PushArray(cg::AsArray<uint16_t>(n1), 4);
-		auto b = cg::BigNum<uint16_t, 4>();
-		b.PushArray(cg::AsArray<uint16_t>(n2), 4);
+		auto a = cg::BigNum<T, Units64<T>::value>();
+		a.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
+		auto b = cg::BigNum<T, Units64<T>::value>();
+		b.PushArray(cg::AsArray<T>(n2), 8 / sizeof(T));
 		uint64_t answer = n1 / n2;
 		auto funcLambda = [&]()
 		{
@@ -201,19 +337,22 @@ bool TestBigNumDiv(std::size_t amt)
 
 	return false;
 }
+template<typename T>
 bool TestBigNumMul(std::size_t amt)
 {
 	std::srand((unsigned int)std::time(0));
 	double time = 0.0;
 	for (std::size_t i = 0; i < amt; ++i)
 	{
-		uint32_t n1 = (uint32_t) RandomU64();
-		uint32_t n2 = (uint32_t) RandomU64();
-		auto a = cg::BigNum<uint16_t, 4>();
-		a.PushArray(cg::AsArray<uint16_t>(n1), 2);
-		auto b = cg::BigNum<uint16_t, 2>();
-		b.PushArray(cg::AsArray<uint16_t>(n2), 2);
-		uint64_t answer = uint64_t(n1) * n2;
+		uint64_t n1 = (uint32_t) RandomU64();
+		uint64_t n2 = (uint32_t) RandomU64();
+		/*b has half the digits of a (one when they are 64 bit).*/
+		const std::size_t half = (4 + sizeof(T) - 1) / sizeof(T);
+		auto a = cg::BigNum<T, Units64<T>::value>();
+		a.PushArray(cg::AsArray<T>(n1), half);
+		auto b = cg::BigNum<T, 2>();
+		b.PushArray(cg::AsArray<T>(n2), half);
+		uint64_t answer = n1 * n2;
 		auto funcLambda = [&]()
 		{
 			a *= b;
@@ -228,6 +367,7 @@ bool TestBigNumMul(std::size_t amt)
 
 	return false;
 }
+template<typename T>
 bool TestBigLShift(std::size_t amt)
 {
 	std::srand((unsigned int)std::time(0));
@@ -236,10 +376,10 @@ bool TestBigLShift(std::size_t amt)
 	{
 		uint64_t n1 = RandomU64_2();
 		uint64_t originN1 = n1;
-		auto a = cg::BigNum<uint16_t, 4>();
-		a.PushArray(cg::AsArray<uint16_t>(n1), 4);
-		auto originA = cg::BigNum<uint16_t, 4>();
-		originA.PushArray(cg::AsArray<uint16_t>(n1), 4);
+		auto a = cg::BigNum<T, Units64<T>::value>();
+		a.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
+		auto originA = cg::BigNum<T, Units64<T>::value>();
+		originA.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
 		int shiftAmt = rand() % 64;
 		n1 <<= shiftAmt;
 		auto funcLambda = [&]()
@@ -257,6 +397,7 @@ bool TestBigLShift(std::size_t amt)
 
 	return false;
 }
+template<typename T>
 bool TestBigRShift(std::size_t amt)
 {
 	std::srand((unsigned int)std::time(0));
@@ -265,10 +406,10 @@ bool TestBigRShift(std::size_t amt)
 	{
 		uint64_t n1 = RandomU64_2();
 		uint64_t originN1 = n1;
-		auto a = cg::BigNum<uint16_t, 4>();
-		a.PushArray(cg::AsArray<uint16_t>(n1), 4);
-		auto originA = cg::BigNum<uint16_t, 4>();
-		originA.PushArray(cg::AsArray<uint16_t>(n1), 4);
+		auto a = cg::BigNum<T, Units64<T>::value>();
+		a.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
+		auto originA = cg::BigNum<T, Units64<T>::value>();
+		originA.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
 		int shiftAmt = rand() % 64;
 		n1 >>= shiftAmt;
 		auto funcLambda = [&]()
@@ -287,6 +428,7 @@ bool TestBigRShift(std::size_t amt)
 	return false;
 }
 
+template<typename T>
 bool TestBigNumMod(std::size_t amt)
 {
 	std::srand((unsigned int)std::time(0));
@@ -303,10 +445,10 @@ bool TestBigNumMod(std::size_t amt)
 		}
 		if (n2 == 0)
 			n2 = 1;
-		auto a = cg::BigNum<uint16_t, 4>();
-		a.PushArray(cg::AsArray<uint16_t>(n1), 4);
-		auto b = cg::BigNum<uint16_t, 4>();
-		b.PushArray(cg::AsArray<uint16_t>(n2), 4);
+		auto a = cg::BigNum<T, Units64<T>::value>();
+		a.PushArray(cg::AsArray<T>(n1), 8 / sizeof(T));
+		auto b = cg::BigNum<T, Units64<T>::value>();
+		b.PushArray(cg::AsArray<T>(n2), 8 / sizeof(T));
 		uint64_t answer = n1 % n2;
 		auto funcLambda = [&]()
 		{
@@ -321,4 +463,1581 @@ bool TestBigNumMod(std::size_t amt)
 	std::cout << " Mod: " << time / amt << std::endl;
 
 	return false;
-}
\ No newline at end of file
+}
+template<typename T>
+bool TestAddSubCarry(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		uint64_t n1 = RandomU64_2();
+		uint64_t n2 = RandomU64_2();
+		uint64_t a = n1;
+		uint64_t s = n1;
+		bool carry = false;
+		bool borrow = false;
+		auto funcLambda = [&]()
+		{
+			carry = cg::AddArray(cg::AsArray<T>(a), 8 / sizeof(T),
+				cg::AsArray<T>(n2), 8 / sizeof(T));
+			borrow = cg::SubArray(cg::AsArray<T>(s), 8 / sizeof(T),
+				cg::AsArray<T>(n2), 8 / sizeof(T));
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(a == n1 + n2 && carry == (n1 + n2 < n1));
+		assert(s == n1 - n2 && borrow == (n2 > n1));
+	}
+	std::cout << "AdSC: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+void RandomArray(T* arr, std::size_t s)
+{
+	for (std::size_t i = 0; i < s; ++i)
+		for (std::size_t j = 0; j < sizeof(T); ++j)
+			((uint8_t*)(arr + i))[j] = (uint8_t)(std::rand() % 256);
+}
+template<typename T>
+bool TestMulKaratsuba(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		std::size_t na = 32 + std::rand() % 400;
+		std::size_t nb = 32 + std::rand() % 400;
+		T* a = new T[na];
+		T* b = new T[nb];
+		T* answer = new T[na + nb];
+		T* r = new T[na + nb];
+		RandomArray(a, na);
+		RandomArray(b, nb);
+		cg::MulArray_School(answer, a, na, b, nb);
+		auto funcLambda = [&]()
+		{
+			cg::MulArray(r, a, na, b, nb);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(cg::CompareArray(answer, na + nb, r, na + nb) == 0);
+		delete[] a;
+		delete[] b;
+		delete[] answer;
+		delete[] r;
+	}
+	std::cout << "KMul: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestMulToom(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		std::size_t na = 8 + std::rand() % 800;
+		std::size_t nb = na / 2 + 1 + std::rand() % (na - na / 2);
+		T* a = new T[na];
+		T* b = new T[nb];
+		T* answer = new T[na + nb];
+		T* r3 = new T[na + nb];
+		T* r4 = new T[na + nb];
+		RandomArray(a, na);
+		RandomArray(b, nb);
+		cg::MulArray_School(answer, a, na, b, nb);
+		auto funcLambda = [&]()
+		{
+			cg::MulArray_Toom3(r3, a, na, b, nb);
+			cg::MulArray_Toom4(r4, a, na, b, nb);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(cg::CompareArray(answer, na + nb, r3, na + nb) == 0);
+		assert(cg::CompareArray(answer, na + nb, r4, na + nb) == 0);
+
+		cg::BigNum<T, 2048> x;
+		x.PushArray(a, na);
+		cg::BigNum<T, 2048> y;
+		y.PushArray(b, nb);
+		x.SetMulFunc(&cg::MulArray_Toom3<T>);
+		x *= y;
+		assert(cg::CompareArray(answer, na + nb, x.Begin(), na + nb) == 0);
+		delete[] a;
+		delete[] b;
+		delete[] answer;
+		delete[] r3;
+		delete[] r4;
+	}
+	std::cout << "TMul: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestMulNTT(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		std::size_t na = 1 + std::rand() % 3000;
+		std::size_t nb = 1 + std::rand() % 3000;
+		if (na < nb)
+			std::swap(na, nb);
+		T* a = new T[na];
+		T* b = new T[nb];
+		T* answer = new T[na + nb];
+		RandomArray(a, na);
+		RandomArray(b, nb);
+		cg::MulArray_Karatsuba(answer, a, na, b, nb);
+
+		cg::BigNum<T, 0> x;
+		x.PushArray(a, na);
+		cg::BigNum<T, 0> y;
+		y.PushArray(b, nb);
+		x.SetMulFunc(&cg::MulArray_NTT<T>);
+		auto funcLambda = [&]()
+		{
+			x *= y;
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(x.RealSize() == cg::RealSize(answer, na + nb));
+		assert(cg::CompareArray(answer, x.RealSize(), x.Begin(),
+			x.RealSize()) == 0);
+		delete[] a;
+		delete[] b;
+		delete[] answer;
+	}
+	std::cout << "NMul: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestSqr(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		std::size_t n = 1 + std::rand() % (i % 5 ? 600 : 6000);
+		T* a = new T[n];
+		T* b = new T[n];
+		T* answer = new T[n + n];
+		T* r = new T[n + n];
+		RandomArray(a, n);
+		std::memcpy(b, a, n * sizeof(T));
+		cg::MulArray_Karatsuba(answer, a, n, b, n);
+		cg::SqrArray_School(r, a, n);
+		assert(cg::CompareArray(answer, n + n, r, n + n) == 0);
+		cg::SqrArray_Karatsuba(r, a, n);
+		assert(cg::CompareArray(answer, n + n, r, n + n) == 0);
+
+		cg::BigNum<T, 0> x;
+		x.PushArray(a, n);
+		auto funcLambda = [&]()
+		{
+			x *= x;
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(x.RealSize() == cg::RealSize(answer, n + n));
+		assert(cg::CompareArray(answer, x.RealSize(), x.Begin(),
+			x.RealSize()) == 0);
+		delete[] a;
+		delete[] b;
+		delete[] answer;
+		delete[] r;
+	}
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		uint64_t n = RandomU64();
+		std::size_t e = std::rand() % 64;
+		uint64_t answer = 1;
+		for (std::size_t j = 0; j < e; ++j)
+			answer *= n;
+		auto x = cg::BigNum<uint16_t, 4>();
+		x.PushArray(cg::AsArray<uint16_t>(n), 4);
+		cg::PowInPlace(x, e);
+		assert(answer == *((uint64_t*)x.Begin()));
+	}
+	std::cout << "SSqr: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+void RandomDivArray(T* arr, std::size_t s)
+{
+	/*Units near the edges make the quotient estimates need correcting.*/
+	const T edges[] = { T(0), T(1), T(~T(0)), T(~T(0) - 1),
+		T(T(1) << (sizeof(T) * 8 - 1)) };
+	RandomArray(arr, s);
+	for (std::size_t i = 0; i < s; ++i)
+		if (std::rand() % 2)
+			arr[i] = edges[std::rand() % 5];
+}
+template<typename T>
+bool TestDivKnuth(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t nb = 1 + std::rand() % 40;
+		const std::size_t nq = 1 + std::rand() % 40;
+		const std::size_t na = nb + nq;
+		T* a = new T[na];
+		T* b = new T[nb];
+		T* q = new T[nq];
+		T* r = new T[na];
+		T* mod = new T[na];
+		RandomDivArray(b, nb);
+		if (cg::IsZero(b, nb))
+			b[0] = 1;
+		RandomDivArray(q, nq);
+		/*a = b * q + r, with r < b.*/
+		cg::ZeroOut(r, na);
+		RandomDivArray(r, nb);
+		while (cg::CompareArray(r, nb, b, nb) != -1)
+			cg::ShiftInsigB(r, nb, 1);
+		cg::MulArray(a, b, nb, q, nq);
+		cg::AddArray(a, na, r, nb);
+
+		auto funcLambda = [&]()
+		{
+			cg::DivArray_Knuth(a, na, b, nb, mod);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(cg::RealSize(a + nq, na - nq) == 0);
+		assert(cg::CompareArray(a, nq, q, nq) == 0);
+		assert(cg::CompareArray(mod, na, r, na) == 0);
+		delete[] a;
+		delete[] b;
+		delete[] q;
+		delete[] r;
+		delete[] mod;
+	}
+	std::cout << "KDiv: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestDivSplit(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t nb = 1 + std::rand() % 1500;
+		const std::size_t na = nb + 1 + std::rand() % 3000;
+		T* a = new T[na];
+		T* b = new T[nb];
+		T* q = new T[na];
+		T* mod = new T[na];
+		T* mod2 = new T[na];
+		RandomDivArray(a, na);
+		RandomDivArray(b, nb);
+		if (cg::IsZero(b, nb))
+			b[0] = 1;
+		std::memcpy(q, a, na * sizeof(T));
+		cg::DivArray_Knuth(q, na, b, nb, mod);
+
+		cg::BigNum<T, 0> x;
+		x.PushArray(a, na);
+		cg::BigNum<T, 0> y;
+		y.PushArray(b, nb);
+		x.SetDivFunc(&cg::DivArray_Split<T>);
+		auto funcLambda = [&]()
+		{
+			x /= y;
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(cg::CompareArray(q, na, x.Begin(), x.Size()) == 0);
+		cg::DivArray_Split(a, na, b, nb, mod2);
+		assert(cg::CompareArray(q, na, a, na) == 0);
+		assert(cg::CompareArray(mod, na, mod2, na) == 0);
+		delete[] a;
+		delete[] b;
+		delete[] q;
+		delete[] mod;
+		delete[] mod2;
+	}
+	std::cout << "SDiv: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestDivNewton(std::size_t amt)
+{
+	/*Use the reciprocal on small numbers too.*/
+	const std::size_t threshold = cg::Thresholds::Newton;
+	cg::Thresholds::Newton = 4;
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t nb = 1 + std::rand() % 400;
+		const std::size_t na = nb + 1 + std::rand() % 800;
+		T* a = new T[na];
+		T* b = new T[nb];
+		T* q = new T[na];
+		T* mod = new T[na];
+		T* mod2 = new T[na];
+		RandomDivArray(a, na);
+		RandomDivArray(b, nb);
+		if (cg::IsZero(b, nb))
+			b[0] = 1;
+		std::memcpy(q, a, na * sizeof(T));
+		cg::DivArray_Knuth(q, na, b, nb, mod);
+
+		cg::BigNum<T, 0> x;
+		x.PushArray(a, na);
+		cg::BigNum<T, 0> y;
+		y.PushArray(b, nb);
+		x.SetDivFunc(&cg::DivArray_Newton<T>);
+		auto funcLambda = [&]()
+		{
+			x /= y;
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(cg::CompareArray(q, na, x.Begin(), x.Size()) == 0);
+		cg::DivArray_Newton(a, na, b, nb, mod2);
+		assert(cg::CompareArray(q, na, a, na) == 0);
+		assert(cg::CompareArray(mod, na, mod2, na) == 0);
+
+		/*The reciprocal is floor(B^(2n) / b) for a normalized b.*/
+		b[nb - 1] |= T(1) << (sizeof(T) * 8 - 1);
+		T* inv = new T[nb + nb + 1];
+		cg::ZeroOut(inv, nb + nb + 1);
+		inv[nb + nb] = 1;
+		cg::DivArray_Knuth(inv, nb + nb + 1, b, nb, (T*)nullptr);
+		cg::InvertArray(q, b, nb);
+		assert(cg::CompareArray(inv, nb + 1, q, nb + 1) == 0);
+		delete[] inv;
+		delete[] a;
+		delete[] b;
+		delete[] q;
+		delete[] mod;
+		delete[] mod2;
+	}
+	cg::Thresholds::Newton = threshold;
+	std::cout << "NDiv: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestDivUnit(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t na = 1 + std::rand() % 40;
+		T* a = new T[na];
+		T* q = new T[na + 1];
+		RandomDivArray(a, na);
+		T d = 0;
+		while (d == 0)
+			RandomDivArray(&d, 1);
+		std::memcpy(q, a, na * sizeof(T));
+		T r = 0;
+		auto funcLambda = [&]()
+		{
+			r = cg::DivArray(q, na, d);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		/*a = q * d + r, with r < d.*/
+		assert(r < d);
+		q[na] = cg::MulArray(q, na, d);
+		assert(!cg::AddArray(q, na + 1, &r, 1));
+		assert(q[na] == 0);
+		assert(cg::CompareArray(q, na, a, na) == 0);
+		delete[] a;
+		delete[] q;
+	}
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		uint64_t n1 = RandomU64();
+		uint16_t n2 = uint16_t(RandomU64());
+		if (n2 == 0)
+			n2 = 1;
+		auto a = cg::BigNum<uint16_t, 4>();
+		a.PushArray(cg::AsArray<uint16_t>(n1), 4);
+		auto b = a;
+		a /= n2;
+		b %= n2;
+		assert(*((uint64_t*)a.Begin()) == n1 / n2);
+		assert(*((uint64_t*)b.Begin()) == n1 % n2);
+	}
+	std::cout << "UDiv: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestDivMod(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	const std::size_t threshold = cg::Thresholds::Newton;
+	cg::Thresholds::Newton = 4;
+	cg::BigNum<T, 0> q;
+	cg::BigNum<T, 0> r;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t nb = 1 + std::rand() % 40;
+		const std::size_t na = 1 + std::rand() % 80;
+		T* a = new T[na + 1];
+		T* b = new T[nb];
+		T* q1 = new T[na];
+		T* r1 = new T[na];
+		T* r2 = new T[na + 1];
+		RandomDivArray(a, na);
+		RandomDivArray(b, nb);
+		if (cg::IsZero(b, nb))
+			b[0] = 1;
+		std::memcpy(q1, a, na * sizeof(T));
+		cg::DivArray_Knuth(q1, na, b, nb, r1);
+		/*a = q * b + r, with r < b.*/
+		T* check = new T[na + nb];
+		cg::MulArray(check, q1, na, b, nb);
+		cg::AddArray(check, na + nb, r1, na);
+		assert(cg::CompareArray(check, na, a, na) == 0);
+		assert(cg::RealSize(check + na, nb) == 0);
+		assert(cg::CompareArray(r1, cg::RealSize(r1, na), b,
+			cg::RealSize(b, nb)) == -1);
+		delete[] check;
+
+		cg::BigNum<T, 0> x;
+		x.PushArray(a, na);
+		cg::BigNum<T, 0> y;
+		y.PushArray(b, nb);
+		auto funcLambda = [&]()
+		{
+			x.DivMod(y, q, r);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		/*q and r only have room for one digit more than the real size of x.*/
+		assert(cg::CompareArray(q1, cg::RealSize(q1, na), q.Begin(),
+			cg::RealSize(q.Begin(), q.Size())) == 0);
+		assert(cg::CompareArray(r1, cg::RealSize(r1, na), r.Begin(),
+			cg::RealSize(r.Begin(), r.Size())) == 0);
+		/*The quotient may be written over the dividend.*/
+		cg::DivMod(a, na, b, nb, a, r2);
+		assert(cg::CompareArray(q1, na, a, na) == 0);
+		assert(cg::CompareArray(r1, na, r2, na) == 0);
+		/*The divisor may be written over by either result.*/
+		cg::BigNum<T, 0> d = y;
+		x.DivMod(d, q, d);
+		assert(cg::CompareArray(r1, cg::RealSize(r1, na), d.Begin(),
+			d.RealSize()) == 0);
+		d = y;
+		x.DivMod(d, d, r);
+		assert(cg::CompareArray(q1, cg::RealSize(q1, na), d.Begin(),
+			d.RealSize()) == 0);
+		d = y;
+		d %= d;
+		assert(d.IsZero());
+		/*The remainder alone, with each divide function.*/
+		cg::BigNum<T, 0> z = x;
+		if (i % 2)
+			z.SetDivFunc(&cg::DivArray_Split<T>);
+		else
+			z.SetDivFunc(&cg::DivArray_Newton<T>);
+		z %= y;
+		assert(cg::CompareArray(r1, cg::RealSize(r1, na), z.Begin(),
+			z.RealSize()) == 0);
+		const std::size_t sx = x.Size();
+		x %= y;
+		assert(cg::CompareArray(r1, cg::RealSize(r1, na), x.Begin(),
+			x.RealSize()) == 0);
+		assert(x.Size() == sx);
+		/*Again, now that x has room.*/
+		x = cg::BigNum<T, 0>();
+		x.PushArray(q1, na);
+		x *= y;
+		x += z;
+		x %= y;
+		assert(cg::CompareArray(r1, cg::RealSize(r1, na), x.Begin(),
+			x.RealSize()) == 0);
+		delete[] a;
+		delete[] b;
+		delete[] q1;
+		delete[] r1;
+		delete[] r2;
+	}
+	cg::Thresholds::Newton = threshold;
+	std::cout << "DvMd: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestBarrett(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t nb = 1 + std::rand() % 40;
+		/*Mostly products of two residues, sometimes much larger.*/
+		const std::size_t na = std::rand() % 4 ? 1 + std::rand() % (nb + nb)
+			: 1 + std::rand() % (6 * nb);
+		T* a = new T[na];
+		T* b = new T[nb];
+		T* q = new T[na];
+		T* r = new T[na];
+		RandomDivArray(a, na);
+		RandomDivArray(b, nb);
+		if (cg::IsZero(b, nb))
+			b[0] = 1;
+		std::memcpy(q, a, na * sizeof(T));
+		cg::DivArray_Knuth(q, na, b, nb, r);
+
+		cg::BigNum<T, 0> m;
+		m.PushArray(b, nb);
+		cg::BarrettReducer<T, 0> reducer(m);
+		cg::BigNum<T, 0> x;
+		x.PushArray(a, na);
+		auto funcLambda = [&]()
+		{
+			x %= reducer;
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(cg::CompareArray(r, na, x.Begin(), na) == 0);
+		delete[] a;
+		delete[] b;
+		delete[] q;
+		delete[] r;
+	}
+	std::cout << "Barr: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestMontgomery(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t nm = 1 + std::rand() % 40;
+		const std::size_t nb = 1 + std::rand() % nm;
+		const std::size_t na = nb + std::rand() % (nm + 1);
+		T* m = new T[nm];
+		T* a = new T[na];
+		T* b = new T[nb];
+		RandomDivArray(m, nm);
+		RandomDivArray(a, na);
+		RandomDivArray(b, nb);
+		m[0] |= 1;
+		cg::BigNum<T, 0> mod;
+		mod.PushArray(m, nm);
+		cg::MontgomeryReducer<T, 0> reducer(mod);
+		cg::BigNum<T, 0> x;
+		x.PushArray(a, na);
+		cg::BigNum<T, 0> y;
+		y.PushArray(b, nb);
+		cg::MontgomeryInt<T, 0> mx(reducer, x);
+		const cg::MontgomeryInt<T, 0> my(reducer, y);
+
+		const cg::MontgomeryInt<T, 0> ma(reducer, x);
+
+		/*(a + b) * a mod m*/
+		const std::size_t np = na + 1 + na;
+		T* p = new T[na + 1];
+		T* q = new T[np];
+		T* r = new T[np];
+		std::memcpy(p, a, na * sizeof(T));
+		p[na] = 0;
+		cg::AddArray(p, na + 1, b, nb);
+		cg::MulArray(q, p, na + 1, a, na);
+		cg::DivArray_Knuth(q, np, m, nm, r);
+
+		auto funcLambda = [&]()
+		{
+			mx += my;
+			mx *= ma;
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		const auto res = mx.Get();
+		assert(cg::CompareArray(r, cg::RealSize(r, np), res.Begin(),
+			res.RealSize()) == 0);
+		assert(mx - my + my == mx);
+		assert(my - mx + mx == my);
+		delete[] m;
+		delete[] a;
+		delete[] b;
+		delete[] p;
+		delete[] q;
+		delete[] r;
+	}
+	std::cout << "Mont: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestPowMod(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t nm = 1 + std::rand() % 20;
+		const std::size_t nb = 1 + std::rand() % (nm + nm);
+		const std::size_t ne = std::rand() % 5;
+		T* m = new T[nm];
+		T* b = new T[nb];
+		T* e = new T[ne + 1];
+		RandomDivArray(m, nm);
+		RandomDivArray(b, nb);
+		RandomDivArray(e, ne);
+		if (cg::IsZero(m, nm))
+			m[0] = 1;
+
+		/*Right to left square and multiply, dividing after each product.*/
+		T* acc = new T[nm + nm];
+		T* sq = new T[nm + nm];
+		T* t = new T[nm + nm];
+		T* rem = new T[nb > nm + nm ? nb : nm + nm];
+		auto mulMod = [&](T* x, const T* y)
+		{
+			cg::MulArray(t, x, nm, y, nm);
+			cg::DivArray_Knuth(t, nm + nm, m, nm, rem);
+			std::memcpy(x, rem, nm * sizeof(T));
+		};
+		cg::ZeroOut(acc, nm + nm);
+		acc[0] = 1;
+		cg::DivArray_Knuth(acc, nm, m, nm, rem);
+		std::memcpy(acc, rem, nm * sizeof(T));
+		cg::ZeroOut(sq, nm + nm);
+		T* bq = new T[nb];
+		std::memcpy(bq, b, nb * sizeof(T));
+		cg::DivArray_Knuth(bq, nb, m, nm, rem);
+		std::memcpy(sq, rem, (nb < nm ? nb : nm) * sizeof(T));
+		for (std::size_t j = 0; j < ne * sizeof(T) * 8; ++j)
+		{
+			if ((e[j / (sizeof(T) * 8)] >> (j % (sizeof(T) * 8))) & 1)
+				mulMod(acc, sq);
+			mulMod(sq, sq);
+		}
+
+		cg::BigNum<T, 0> x;
+		x.PushArray(b, nb);
+		cg::BigNum<T, 0> y;
+		if (ne)
+			y.PushArray(e, ne);
+		cg::BigNum<T, 0> z;
+		z.PushArray(m, nm);
+		cg::BigNum<T, 0> res;
+		auto funcLambda = [&]()
+		{
+			res = cg::PowMod(x, y, z);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(cg::CompareArray(acc, cg::RealSize(acc, nm), res.Begin(),
+			res.RealSize()) == 0);
+		delete[] m;
+		delete[] b;
+		delete[] e;
+		delete[] acc;
+		delete[] sq;
+		delete[] t;
+		delete[] rem;
+		delete[] bq;
+	}
+	std::cout << "PMod: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestGCD(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		/*a = x * c and b = y * c, so the GCD is at least c.*/
+		const std::size_t nc = 1 + std::rand() % 10;
+		const std::size_t nx = 1 + std::rand() % 30;
+		const std::size_t ny = 1 + std::rand() % 30;
+		const std::size_t na = nx + nc;
+		const std::size_t nb = ny + nc;
+		T* c = new T[nc];
+		T* x = new T[nx];
+		T* y = new T[ny];
+		RandomDivArray(c, nc);
+		RandomDivArray(x, nx);
+		RandomDivArray(y, ny);
+		c[0] |= 1;
+		x[0] |= 1;
+		y[0] |= 1;
+		T* a = new T[na];
+		T* b = new T[nb];
+		cg::MulArray(a, x, nx, c, nc);
+		cg::MulArray(b, y, ny, c, nc);
+
+		/*Euclid's algorithm with a full division each step.*/
+		const std::size_t nu = na > nb ? na : nb;
+		T* u = new T[nu];
+		T* v = new T[nu];
+		T* r = new T[nu];
+		cg::ZeroOut(u, nu);
+		cg::ZeroOut(v, nu);
+		std::memcpy(u, a, na * sizeof(T));
+		std::memcpy(v, b, nb * sizeof(T));
+		while (!cg::IsZero(v, nu))
+		{
+			cg::DivArray_Knuth(u, nu, v, nu, r);
+			std::memcpy(u, v, nu * sizeof(T));
+			std::memcpy(v, r, nu * sizeof(T));
+		}
+		const std::size_t ng = cg::RealSize(u, nu);
+
+		T* a2 = new T[na];
+		T* b2 = new T[nb];
+		std::memcpy(a2, a, na * sizeof(T));
+		std::memcpy(b2, b, nb * sizeof(T));
+		std::size_t n2 = cg::GCDArray_Binary(a2, na, b2, nb);
+		assert(cg::CompareArray(u, ng, a2, n2) == 0);
+		assert(cg::RealSize(a2, na) == n2);
+		std::memcpy(a2, a, na * sizeof(T));
+		std::memcpy(b2, b, nb * sizeof(T));
+		n2 = cg::GCDArray_Lehmer(a2, na, b2, nb);
+		assert(cg::CompareArray(u, ng, a2, n2) == 0);
+		assert(cg::RealSize(a2, na) == n2);
+
+		cg::BigNum<T, 0> bx;
+		bx.PushArray(a, na);
+		cg::BigNum<T, 0> by;
+		by.PushArray(b, nb);
+		cg::BigNum<T, 0> g;
+		auto funcLambda = [&]()
+		{
+			g = cg::GCD(bx, by);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		assert(cg::CompareArray(u, ng, g.Begin(), g.RealSize()) == 0);
+		/*a l.first = b l.second = lcm(a, b), with l.first = b / g.*/
+		const cg::LCMPair<cg::BigNum<T, 0>> l = cg::LCM(bx, by);
+		cg::BigNum<T, 0> e = by;
+		e /= g;
+		assert(cg::CompareArray(e.Begin(), e.RealSize(), l.first.Begin(),
+			l.first.RealSize()) == 0);
+		e = bx;
+		e *= l.first;
+		cg::BigNum<T, 0> f = by;
+		f *= l.second;
+		assert(cg::CompareArray(e.Begin(), e.RealSize(), f.Begin(),
+			f.RealSize()) == 0);
+		delete[] c;
+		delete[] x;
+		delete[] y;
+		delete[] a;
+		delete[] b;
+		delete[] u;
+		delete[] v;
+		delete[] r;
+		delete[] a2;
+		delete[] b2;
+	}
+	std::cout << "GCD : " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestExtGCD(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	/*Use the half-GCD on small numbers half of the time.*/
+	const std::size_t threshold = cg::Thresholds::HalfGCD;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		cg::Thresholds::HalfGCD = i % 2 ? threshold : 4;
+		const std::size_t nc = 1 + std::rand() % 10;
+		const std::size_t nx = 1 + std::rand() % 60;
+		const std::size_t ny = 1 + std::rand() % 60;
+		const std::size_t na = nx + nc;
+		const std::size_t nb = ny + nc;
+		const std::size_t n = na > nb ? na : nb;
+		T* c = new T[nc];
+		T* x = new T[nx];
+		T* y = new T[ny];
+		RandomDivArray(c, nc);
+		RandomDivArray(x, nx);
+		RandomDivArray(y, ny);
+		c[0] |= 1;
+		x[0] |= 1;
+		y[0] |= 1;
+		T* a = new T[n];
+		T* b = new T[n];
+		cg::ZeroOut(a, n);
+		cg::ZeroOut(b, n);
+		cg::MulArray(a, x, nx, c, nc);
+		cg::MulArray(b, y, ny, c, nc);
+
+		T* g1 = new T[n];
+		T* b1 = new T[n];
+		std::memcpy(g1, a, n * sizeof(T));
+		std::memcpy(b1, b, n * sizeof(T));
+		const std::size_t ng = cg::GCDArray_Lehmer(g1, n, b1, n);
+		std::memcpy(b1, a, n * sizeof(T));
+		T* b2 = new T[n];
+		std::memcpy(b2, b, n * sizeof(T));
+		const std::size_t ng2 = cg::GCDArray_HalfGCD(b1, n, b2, n);
+		assert(cg::CompareArray(g1, ng, b1, ng2) == 0);
+
+		cg::BigNum<T, 0> bx;
+		bx.PushArray(a, na);
+		cg::BigNum<T, 0> by;
+		by.PushArray(b, nb);
+		cg::BigNum<T, 0> g;
+		cg::BigNum<T, 0> cx;
+		cg::BigNum<T, 0> cy;
+		auto funcLambda = [&]()
+		{
+			g = cg::ExtGCD(bx, by, &cx, &cy);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		/*a x - b y = g, 1 <= x <= b / g and y < a / g*/
+		assert(cg::CompareArray(g1, ng, g.Begin(), g.RealSize()) == 0);
+		const std::size_t sx = cx.RealSize();
+		const std::size_t sy = cy.RealSize();
+		assert(sx > 0);
+		T* p1 = new T[n + n + 1];
+		T* p2 = new T[n + n + 1];
+		cg::ZeroOut(p1, n + n + 1);
+		cg::ZeroOut(p2, n + n + 1);
+		cg::MulArray(p1, a, na, cx.Begin(), sx);
+		if (sy)
+			cg::MulArray(p2, b, nb, cy.Begin(), sy);
+		assert(!cg::SubArray(p1, n + n + 1, p2, n + n + 1));
+		assert(cg::CompareArray(g1, ng, p1, cg::RealSize(p1, n + n + 1)) == 0);
+		cg::ZeroOut(p1, n + n + 1);
+		cg::MulArray(p1, g1, ng, cx.Begin(), sx);
+		assert(cg::CompareArray(p1, cg::RealSize(p1, n + n + 1), b, nb) != 1);
+		if (sy)
+		{
+			cg::ZeroOut(p1, n + n + 1);
+			cg::MulArray(p1, g1, ng, cy.Begin(), sy);
+			assert(cg::CompareArray(p1, cg::RealSize(p1, n + n + 1), a, na)
+				== -1);
+		}
+
+		/*x is the inverse of a / g modulo b / g.*/
+		if (ng == 1 && g1[0] == 1 && nb)
+		{
+			const auto inv = cg::ModInverse(bx, by);
+			cg::ZeroOut(p1, n + n + 1);
+			cg::MulArray(p1, a, na, inv.Begin(), inv.RealSize());
+			cg::DivArray_Knuth(p1, n + n + 1, b, nb, p2);
+			const T one = 1;
+			if (cg::RealSize(b, nb) == 1 && b[0] == 1)
+				assert(cg::IsZero(p2, n + n + 1));
+			else
+				assert(cg::CompareArray(p2, cg::RealSize(p2, n + n + 1),
+					&one, 1) == 0);
+		}
+		delete[] c;
+		delete[] x;
+		delete[] y;
+		delete[] a;
+		delete[] b;
+		delete[] g1;
+		delete[] b1;
+		delete[] b2;
+		delete[] p1;
+		delete[] p2;
+	}
+	cg::Thresholds::HalfGCD = threshold;
+	std::cout << "EGCD: " << time / amt << std::endl;
+
+	return false;
+}
+template<typename T>
+bool TestRoot(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t n = 1 + std::rand() % 80;
+		T* a = new T[n];
+		RandomArray(a, n);
+		/*Try squares and one less than squares too.*/
+		if (i % 3)
+		{
+			const std::size_t h = (n + 1) / 2;
+			T* x = new T[h];
+			RandomArray(x, h);
+			x[h - 1] |= 1;
+			cg::ZeroOut(a, n);
+			if (h + h <= n)
+				cg::SqrArray(a, x, h);
+			else
+			{
+				T* t = new T[h + h];
+				cg::ZeroOut(t, h + h);
+				cg::SqrArray(t, x, h);
+				std::memcpy(a, t, n * sizeof(T));
+				delete[] t;
+			}
+			if (i % 3 == 2)
+				cg::SubArray(a, n, T(1));
+			delete[] x;
+		}
+		cg::BigNum<T, 0> ba;
+		ba.PushArray(a, n);
+		cg::BigNum<T, 0> s;
+		cg::BigNum<T, 0> r;
+		const std::size_t k = 3 + std::rand() % 6;
+		cg::BigNum<T, 0> x;
+		auto funcLambda = [&]()
+		{
+			s = cg::ISqrtRem(ba, &r);
+			x = cg::IRoot(ba, k);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		/*s^2 + r = a and r <= 2 s, so a < (s + 1)^2*/
+		const std::size_t ns = s.RealSize();
+		T* p = new T[n + n + 2];
+		cg::ZeroOut(p, n + n + 2);
+		if (ns)
+			cg::SqrArray(p, s.Begin(), ns);
+		cg::AddArray(p, n + n + 2, r.Begin(), r.RealSize());
+		assert(cg::CompareArray(p, cg::RealSize(p, n + n + 2), a,
+			cg::RealSize(a, n)) == 0);
+		cg::ZeroOut(p, n + n + 2);
+		std::memcpy(p, s.Begin(), ns * sizeof(T));
+		cg::AddArray(p, n + n + 2, s.Begin(), ns);
+		assert(cg::CompareArray(r.Begin(), r.RealSize(), p,
+			cg::RealSize(p, n + n + 2)) != 1);
+		assert(cg::CompareArray(s.Begin(), ns, cg::ISqrt(ba).Begin(),
+			cg::ISqrt(ba).RealSize()) == 0);
+
+		/*x^k <= a < (x + 1)^k*/
+		const std::size_t nx = x.RealSize();
+		T* x1 = new T[nx + 1];
+		cg::ZeroOut(x1, nx + 1);
+		std::memcpy(x1, x.Begin(), nx * sizeof(T));
+		T* q = new T[(nx + 1) * k];
+		T* w = new T[(nx + 1) * k];
+		std::size_t nq = nx ? cg::PowArray(q, x1, nx, k, w) : 0;
+		assert(cg::CompareArray(q, nq, a, cg::RealSize(a, n)) != 1);
+		cg::AddArray(x1, nx + 1, T(1));
+		nq = cg::PowArray(q, x1, nx + 1, k, w);
+		assert(cg::CompareArray(q, nq, a, cg::RealSize(a, n)) == 1);
+		delete[] a;
+		delete[] p;
+		delete[] x1;
+		delete[] q;
+		delete[] w;
+	}
+	/*Roots past the largest unit, 2^(e / k) rounded down.*/
+	const std::size_t ek[3][3] = { { 127984, 70000, 3 }, { 196616, 65537, 8 },
+		{ 200000, 199999, 2 } };
+	for (std::size_t i = 0; i < 3; ++i)
+	{
+		const std::size_t TBits = sizeof(T) * 8;
+		const std::size_t n = ek[i][0] / TBits + 1;
+		T* a = new T[n];
+		cg::ZeroOut(a, n);
+		a[n - 1] = T(T(1) << (ek[i][0] % TBits));
+		cg::BigNum<T, 0> ba;
+		ba.PushArray(a, n);
+		const cg::BigNum<T, 0> x = cg::IRoot(ba, ek[i][1]);
+		assert(x.RealSize() == 1 && x.Begin()[0] == T(ek[i][2]));
+		delete[] a;
+	}
+	std::cout << "Root: " << time / amt << std::endl;
+	return false;
+}
+template<typename T>
+cg::BigNum<T, 0> BigFromU64(uint64_t v)
+{
+	cg::BigNum<T, 0> r;
+	r.PushArray((const T*)&v, sizeof(v) / sizeof(T));
+	return r;
+}
+template<typename T>
+bool TestPrime(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	const std::size_t TBits = sizeof(T) * 8;
+	/*Strong pseudoprimes to base 2 and strong Lucas pseudoprimes.*/
+	const uint64_t spsp[] = { 2047, 3277, 4033, 4681, 8321 };
+	const uint64_t slpsp[] = { 5459, 5777, 10877, 16109, 18971 };
+	for (const uint64_t v : spsp)
+	{
+		const auto n = BigFromU64<T>(v);
+		assert(cg::MillerRabin(n, BigFromU64<T>(2)));
+		assert(!cg::IsProbablePrime(n));
+	}
+	for (const uint64_t v : slpsp)
+	{
+		const auto n = BigFromU64<T>(v);
+		assert(cg::StrongLucas(n));
+		assert(!cg::IsProbablePrime(n));
+	}
+	/*2^p - 1 is prime for these p and not for the others.*/
+	const std::size_t mersenne[] = { 61, 89, 107, 127, 521, 607,
+		67, 71, 73, 79, 83, 97, 101, 103, 109, 113 };
+	for (std::size_t i = 0; i < 16; ++i)
+	{
+		const std::size_t p = mersenne[i];
+		cg::BigNum<T, 0> n;
+		n.ExpandTo(p / TBits + 1);
+		cg::ZeroOut(n.Begin(), n.Size());
+		n.Begin()[p / TBits] = T(T(1) << (p % TBits));
+		cg::SubArray(n.Begin(), n.Size(), T(1));
+		assert(cg::IsProbablePrime(n) == (i < 6));
+		if (i < 6)
+			assert(cg::StrongLucas(n));
+	}
+	/*Small numbers against trial division.*/
+	for (std::size_t i = 0; i < amt * 10; ++i)
+	{
+		const uint64_t v = (uint64_t(std::rand()) << 16 ^ std::rand())
+			& 0xffffffff;
+		bool prime = v > 1;
+		for (uint64_t d = 2; d * d <= v && prime; ++d)
+			if (v % d == 0)
+				prime = false;
+		assert(cg::IsProbablePrime(BigFromU64<T>(v)) == prime);
+	}
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t n = 1 + std::rand() % (64 / sizeof(T));
+		const std::size_t count = 16;
+		cg::BigNum<T, 0> nums[count];
+		bool out[count];
+		for (std::size_t j = 0; j < count; ++j)
+		{
+			T* a = new T[n];
+			RandomArray(a, n);
+			a[0] |= 1;
+			a[n - 1] |= T(T(1) << (TBits - 1));
+			nums[j].PushArray(a, n);
+			delete[] a;
+		}
+		std::size_t found = 0;
+		auto funcLambda = [&]()
+		{
+			found = cg::IsProbablePrime(nums, count, out);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+		std::size_t check = 0;
+		for (std::size_t j = 0; j < count; ++j)
+		{
+			assert(cg::IsProbablePrime(nums[j], 2) == out[j]);
+			if (out[j])
+				++check;
+		}
+		assert(check == found);
+		/*A product of two probable primes is composite.*/
+		std::size_t p = count;
+		for (std::size_t j = 0; j < count; ++j)
+		{
+			if (!out[j])
+				continue;
+			if (p != count)
+			{
+				cg::BigNum<T, 0> c = nums[p];
+				c *= nums[j];
+				assert(!cg::IsProbablePrime(c));
+				assert(!cg::MillerRabin(c, BigFromU64<T>(2)));
+			}
+			p = j;
+		}
+	}
+	std::cout << "Prim: " << time / amt << std::endl;
+	return false;
+}
+bool TestSieve(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	const uint64_t counts[9] = { 0, 4, 25, 168, 1229, 9592, 78498, 664579,
+		5761455 };
+	uint64_t ten = 1;
+	for (std::size_t i = 0; i < 9; ++i, ten *= 10)
+	{
+		assert(cg::PrimeCount(0, ten, 1) == counts[i]);
+		assert(cg::PrimeCount(0, ten) == counts[i]);
+	}
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const uint64_t lo = (uint64_t(std::rand()) << 30 ^ uint64_t(std::rand())
+			<< 15 ^ std::rand()) % (i % 2 ? 1000000000000ull : 100000);
+		const uint64_t hi = lo + std::rand() % 1000000;
+		const std::size_t threads = 1 + std::rand() % 4;
+		/*Check against a plain sieve of the range.*/
+		bool* prime = new bool[hi - lo + 1];
+		for (uint64_t v = lo; v < hi; ++v)
+			prime[v - lo] = v > 1;
+		std::size_t np;
+		uint32_t* table = cg::PrimeTable(uint64_t(std::sqrt(double(hi))) + 2,
+			np);
+		for (std::size_t j = 0; j < np; ++j)
+		{
+			const uint64_t p = table[j];
+			uint64_t v = (lo + p - 1) / p * p;
+			for (v = v < p * p ? p * p : v; v < hi; v += p)
+				prime[v - lo] = false;
+		}
+		uint64_t* found = new uint64_t[hi - lo + 1];
+		std::size_t nf = 0;
+		auto funcLambda = [&]()
+		{
+			cg::SievePrimes(lo, hi, [&](const uint64_t p)
+			{
+				found[nf++] = p;
+			}, threads);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+		std::size_t k = 0;
+		for (uint64_t v = lo; v < hi; ++v)
+		{
+			if (prime[v - lo])
+			{
+				assert(k < nf && found[k] == v);
+				++k;
+			}
+		}
+		assert(k == nf);
+		assert(cg::PrimeCount(lo, hi, threads) == nf);
+		delete[] prime;
+		delete[] table;
+		delete[] found;
+	}
+	std::cout << "Siev: " << time / amt << std::endl;
+	return false;
+}
+template<typename T>
+bool TestFactorial(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const uint64_t n = std::rand() % (i % 10 ? 1000 : 20000);
+		cg::BigNum<T, 0> f;
+		auto funcLambda = [&]()
+		{
+			f = cg::Factorial<T>(n);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		/*Multiply up one at a time.*/
+		const std::size_t s = std::size_t(n) * 2 + 2;
+		T* a = new T[s];
+		cg::ZeroOut(a, s);
+		a[0] = 1;
+		for (uint64_t j = 2; j <= n; ++j)
+			cg::MulArray(a, s, T(j));
+		assert(cg::CompareArray(a, cg::RealSize(a, s), f.Begin(),
+			f.RealSize()) == 0);
+
+		/*n! = C(n, k) k! (n - k)!, both ways of finding C(n, k).*/
+		const uint64_t k = n ? std::rand() % (n + 1) : 0;
+		const uint64_t k2 = n ? std::rand() % (n / 20 + 1) : 0;
+		for (const uint64_t kk : { k, k2 })
+		{
+			cg::BigNum<T, 0> c = cg::Binomial<T>(n, kk);
+			c *= cg::Factorial<T>(kk);
+			c *= cg::Factorial<T>(n - kk);
+			assert(cg::CompareArray(c.Begin(), c.RealSize(), f.Begin(),
+				f.RealSize()) == 0);
+		}
+		assert(cg::Binomial<T>(n, n + 1).RealSize() == 0);
+
+		/*The primorial against trial division.*/
+		const uint64_t m = n % 2000;
+		cg::ZeroOut(a, s);
+		a[0] = 1;
+		for (uint64_t p = 2; p <= m; ++p)
+		{
+			bool prime = true;
+			for (uint64_t d = 2; d * d <= p && prime; ++d)
+				prime = p % d != 0;
+			if (prime)
+				cg::MulArray(a, s, T(p));
+		}
+		const auto pr = cg::Primorial<T>(m);
+		assert(cg::CompareArray(a, cg::RealSize(a, s), pr.Begin(),
+			pr.RealSize()) == 0);
+		delete[] a;
+	}
+	/*C(n, 3) with n past the sieve limit.*/
+	const uint64_t n = (uint64_t(1) << 40) + std::rand();
+	const auto c = cg::Binomial<T>(n, 3);
+	const uint64_t v[3] = { n, n - 1, n - 2 };
+	auto p = cg::Product<T>(v, 3);
+	assert(cg::DivArray(p.Begin(), p.Size(), T(6)) == 0);
+	assert(cg::CompareArray(c.Begin(), c.RealSize(), p.Begin(),
+		p.RealSize()) == 0);
+	std::cout << "Fact: " << time / amt << std::endl;
+	return false;
+}
+template<typename T>
+bool TestFibonacci(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const uint64_t n = std::rand() % (i % 10 ? 2000 : 100000);
+		cg::BigNum<T, 0> f;
+		cg::BigNum<T, 0> l;
+		auto funcLambda = [&]()
+		{
+			f = cg::Fibonacci<T>(n);
+			l = cg::Lucas<T>(n);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		/*L(n)^2 = 5 F(n)^2 + 4 (-1)^n and F(2n) = F(n) L(n)*/
+		cg::BigNum<T, 0> a = l;
+		a.Square();
+		cg::BigNum<T, 0> b = f;
+		b.Square();
+		cg::BigNum<T, 0> five;
+		five = T(5);
+		b *= five;
+		if (n % 2)
+			a += T(4);
+		else
+			b += T(4);
+		assert(cg::CompareArray(a.Begin(), a.RealSize(), b.Begin(),
+			b.RealSize()) == 0);
+		a = f;
+		a *= l;
+		b = cg::Fibonacci<T>(n + n);
+		assert(cg::CompareArray(a.Begin(), a.RealSize(), b.Begin(),
+			b.RealSize()) == 0);
+		if (n > 2000)
+			continue;
+
+		/*Add up one at a time, with x(k+1) = p x(k) + q x(k-1) too.*/
+		const T p = T(std::rand() % 5);
+		const T q = T(std::rand() % 5);
+		cg::BigNum<T, 0> x0;
+		cg::BigNum<T, 0> x1;
+		x0 = T(std::rand());
+		x1 = T(std::rand());
+		cg::BigNum<T, 0> bp;
+		cg::BigNum<T, 0> bq;
+		bp = p;
+		bq = q;
+		cg::BigNum<T, 0> f0;
+		cg::BigNum<T, 0> f1;
+		cg::BigNum<T, 0> y0 = x0;
+		cg::BigNum<T, 0> y1 = x1;
+		f0 = T(0);
+		f1 = T(1);
+		for (uint64_t j = 0; j < n; ++j)
+		{
+			cg::BigNum<T, 0> t = f1;
+			t += f0;
+			f0 = f1;
+			f1 = t;
+			t = y1;
+			t *= bp;
+			cg::BigNum<T, 0> u = y0;
+			u *= bq;
+			t += u;
+			y0 = y1;
+			y1 = t;
+		}
+		assert(cg::CompareArray(f0.Begin(), f0.RealSize(), f.Begin(),
+			f.RealSize()) == 0);
+		const auto x = cg::LinearRecurrence(bp, bq, x0, x1, n);
+		assert(cg::CompareArray(y0.Begin(), y0.RealSize(), x.Begin(),
+			x.RealSize()) == 0);
+	}
+	std::cout << "Fib : " << time / amt << std::endl;
+	return false;
+}
+template<typename T>
+bool TestConstants(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	const char* const digits[3] = {
+		"31415926535897932384626433832795028841971693993751"
+		"058209749445923078164062862089986280348253421170679",
+		"27182818284590452353602874713526624977572470936999"
+		"595749669676277240766303535475945713821785251664274",
+		"06931471805599453094172321214581765680755001343602"
+		"552541206800094933936219696947156058633269964186875"};
+	cg::BigNum<T, 0> (*const funcs[3])(std::size_t) = {
+		cg::Pi<T>, cg::E<T>, cg::Log2<T> };
+	cg::BigNum<T, 0> ten;
+	ten = T(10);
+	double time = 0.0;
+	for (std::size_t c = 0; c < 3; ++c)
+	{
+		/*The first 100 digits, from the digit string.*/
+		cg::BigNum<T, 0> expect;
+		expect = T(0);
+		for (const char* d = digits[c]; *d; ++d)
+		{
+			expect *= ten;
+			expect += T(*d - '0');
+		}
+		const cg::BigNum<T, 0> x = funcs[c](100);
+		assert(cg::CompareArray(x.Begin(), x.RealSize(), expect.Begin(),
+			expect.RealSize()) == 0);
+
+		/*More digits must start with the same digits as fewer.*/
+		for (std::size_t i = 0; i < amt; ++i)
+		{
+			const std::size_t n = std::rand() % (i % 5 ? 1000 : 20000) + 1;
+			const std::size_t m = std::rand() % n;
+			cg::BigNum<T, 0> a;
+			auto funcLambda = [&]()
+			{
+				a = funcs[c](n);
+			};
+			time += cg::Timer::TimedCall(funcLambda).count();
+			const cg::BigNum<T, 0> b = funcs[c](m);
+			cg::BigNum<T, 0> q;
+			cg::BigNum<T, 0> r;
+			a.DivMod(cg::PowerOfTen<T>(n - m), q, r);
+			assert(cg::CompareArray(q.Begin(), q.RealSize(), b.Begin(),
+				b.RealSize()) == 0);
+		}
+	}
+	std::cout << "Cnst: " << time / (3 * amt) << std::endl;
+	return false;
+}
+template<typename T>
+bool TestAddMul(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t n = std::rand() % 40;
+		T* a = new T[n + 1];
+		T* r = new T[n + 1];
+		T* add = new T[n + 1];
+		T* sub = new T[n + 1];
+		T* p = new T[n + 1];
+		RandomArray(a, n);
+		RandomArray(r, n + 1);
+		T m;
+		RandomArray(&m, 1);
+		if (i % 7 == 0)
+			m = std::numeric_limits<T>::max();
+		std::memcpy(add, r, (n + 1) * sizeof(T));
+		std::memcpy(sub, r, (n + 1) * sizeof(T));
+		T carry = 0;
+		T borrow = 0;
+		auto funcLambda = [&]()
+		{
+			carry = cg::AddMulArray(add, a, n, m);
+			borrow = cg::SubMulArray(sub, a, n, m);
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		/*The product with the carry unit on top, added to and taken from r
+		must give the same n units and carry/borrow.*/
+		std::memcpy(p, a, n * sizeof(T));
+		p[n] = cg::MulArray(p, n, m);
+		T* e = new T[n + 2];
+		std::memcpy(e, r, n * sizeof(T));
+		e[n] = 0;
+		e[n + 1] = 0;
+		cg::AddArray(e, n + 2, p, n + 1);
+		assert(cg::CompareArray(e, n, add, n) == 0);
+		assert(e[n] == carry && e[n + 1] == 0);
+		std::memcpy(e, r, n * sizeof(T));
+		e[n] = 0;
+		e[n + 1] = 0;
+		const bool under = cg::SubArray(e, n + 2, p, n + 1);
+		assert(cg::CompareArray(e, n, sub, n) == 0);
+		assert(T(T(0) - e[n]) == borrow && (under == (borrow != 0)));
+		assert(add[n] == r[n] && sub[n] == r[n]);
+
+		/*r + a * m with BigNum::AddMul, and a + a * m with a aliased.*/
+		cg::BigNum<T, 0> x;
+		cg::BigNum<T, 0> y;
+		x.PushArray(r, n + 1);
+		y.PushArray(a, n);
+		cg::BigNum<T, 0> z = y;
+		cg::BigNum<T, 0> bm;
+		bm = m;
+		z *= bm;
+		cg::BigNum<T, 0> w = z;
+		z += x;
+		x.AddMul(y, m);
+		assert(cg::CompareArray(x.Begin(), x.RealSize(), z.Begin(),
+			z.RealSize()) == 0);
+		w += y;
+		y.AddMul(y, m);
+		assert(cg::CompareArray(y.Begin(), y.RealSize(), w.Begin(),
+			w.RealSize()) == 0);
+		delete[] e;
+		delete[] a;
+		delete[] r;
+		delete[] add;
+		delete[] sub;
+		delete[] p;
+	}
+	std::cout << "AdMl: " << time / amt << std::endl;
+	return false;
+}
+template<typename T>
+bool TestScalarMul(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t n = std::rand() % 50;
+		T* a = new T[n];
+		RandomArray(a, n);
+		T m;
+		RandomArray(&m, 1);
+		uint64_t m64 = (RandomU64() << 16 ^ RandomU64()) >> (std::rand() % 64);
+		if (i % 5 == 0)
+			m64 = std::numeric_limits<uint64_t>::max();
+		cg::BigNum<T, 0> x;
+		cg::BigNum<T, 0> y;
+		x.PushArray(a, n);
+		y.PushArray(a, n);
+		auto funcLambda = [&]()
+		{
+			x *= m;
+			y *= m64;
+		};
+		time += cg::Timer::TimedCall(funcLambda).count();
+
+		/*Against the full multiplication by the same value.*/
+		cg::BigNum<T, 0> e;
+		e.PushArray(a, n);
+		cg::BigNum<T, 0> bm;
+		bm = m;
+		e *= bm;
+		assert(cg::CompareArray(x.Begin(), x.RealSize(), e.Begin(),
+			e.RealSize()) == 0);
+		e = cg::BigNum<T, 0>();
+		e.PushArray(a, n);
+		e *= BigFromU64<T>(m64);
+		assert(cg::CompareArray(y.Begin(), y.RealSize(), e.Begin(),
+			e.RealSize()) == 0);
+
+		/*Fixed size numbers keep the low digits.*/
+		cg::BigNum<T, 16> f;
+		cg::BigNum<T, 16> g;
+		const std::size_t nf = n < 16 ? n : 16;
+		f.PushArray(a, nf);
+		g.PushArray(a, nf);
+		f *= m;
+		g *= m64;
+		e = cg::BigNum<T, 0>();
+		e.PushArray(a, nf);
+		e *= bm;
+		e.ExpandTo(16);
+		assert(cg::CompareArray(f.Begin(), f.RealSize(), e.Begin(),
+			cg::RealSize(e.Begin(), 16)) == 0);
+		e = cg::BigNum<T, 0>();
+		e.PushArray(a, nf);
+		e *= BigFromU64<T>(m64);
+		e.ExpandTo(16);
+		assert(cg::CompareArray(g.Begin(), g.RealSize(), e.Begin(),
+			cg::RealSize(e.Begin(), 16)) == 0);
+		delete[] a;
+	}
+	std::cout << "SMul: " << time / amt << std::endl;
+	return false;
+}
+bool TestKernels(std::size_t amt)
+{
+	std::srand((unsigned int)std::time(0));
+	double time = 0.0;
+	const cg::CpuFeatures& cpu = cg::CpuFeatures::Get();
+	for (std::size_t i = 0; i < amt; ++i)
+	{
+		const std::size_t n = std::rand() % 71;
+		uint64_t* a = new uint64_t[n + 1];
+		uint64_t* r = new uint64_t[n + 1];
+		uint64_t* e = new uint64_t[n + 1];
+		uint64_t* k = new uint64_t[n + 1];
+		RandomArray(a, n + 1);
+		RandomArray(r, n + 1);
+		uint64_t m = RandomU64() << 16 ^ RandomU64();
+		/*All ones makes every carry and borrow as big as it can be.*/
+		if (i % 5 == 0)
+			m = std::numeric_limits<uint64_t>::max();
+		if (i % 3 == 0)
+			for (std::size_t j = 0; j < n; ++j)
+				a[j] = std::numeric_limits<uint64_t>::max();
+		if (i % 4 == 0)
+			for (std::size_t j = 0; j < n; ++j)
+				r[j] = i % 8 ? std::numeric_limits<uint64_t>::max() : 0;
+
+		/*Each binding against the generic templates, the detected one last
+		so it stays bound.*/
+		const cg::CpuFeatures none;
+		const cg::CpuFeatures* bindings[2] = { &none, &cpu };
+		for (std::size_t b = 0; b < 2; ++b)
+		{
+			cg::Kernels::Bind(*bindings[b]);
+			std::memcpy(e, r, (n + 1) * sizeof(uint64_t));
+			std::memcpy(k, r, (n + 1) * sizeof(uint64_t));
+			uint64_t ce = cg::AddMulArray<uint64_t>(e, a, n, m);
+			uint64_t ck = 0;
+			auto funcLambda = [&]()
+			{
+				ck = cg::Kernels::AddMul(k, a, n, m);
+			};
+			if (b == 1)
+				time += cg::Timer::TimedCall(funcLambda).count();
+			else
+				funcLambda();
+			assert(ce == ck);
+			assert(cg::CompareArray(e, n + 1, k, n + 1) == 0);
+			std::memcpy(e, r, (n + 1) * sizeof(uint64_t));
+			std::memcpy(k, r, (n + 1) * sizeof(uint64_t));
+			ce = cg::SubMulArray<uint64_t>(e, a, n, m);
+			ck = cg::Kernels::SubMul(k, a, n, m);
+			assert(ce == ck);
+			assert(cg::CompareArray(e, n + 1, k, n + 1) == 0);
+
+			/*r the same array as a.*/
+			std::memcpy(e, a, (n + 1) * sizeof(uint64_t));
+			std::memcpy(k, a, (n + 1) * sizeof(uint64_t));
+			ce = cg::AddMulArray<uint64_t>(e, e, n, m);
+			ck = cg::Kernels::AddMul(k, k, n, m);
+			assert(ce == ck);
+			assert(cg::CompareArray(e, n + 1, k, n + 1) == 0);
+			std::memcpy(e, a, (n + 1) * sizeof(uint64_t));
+			std::memcpy(k, a, (n + 1) * sizeof(uint64_t));
+			ce = cg::SubMulArray<uint64_t>(e, e, n, m);
+			ck = cg::Kernels::SubMul(k, k, n, m);
+			assert(ce == ck);
+			assert(cg::CompareArray(e, n + 1, k, n + 1) == 0);
+		}
+		delete[] a;
+		delete[] r;
+		delete[] e;
+		delete[] k;
+	}
+	std::cout << "Krnl: " << time / amt << std::endl;
+	return false;
+}